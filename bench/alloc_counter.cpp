@@ -0,0 +1,127 @@
+#include <alloc_counter.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void  __libc_free(void* ptr);
+}
+
+namespace
+{
+std::atomic<uint64_t> g_allocations(0);
+std::atomic<uint64_t> g_bytes(0);
+
+inline void CountAllocation(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+} // namespace
+
+extern "C"
+{
+    void* malloc(size_t size)
+    {
+        CountAllocation(size);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size)
+    {
+        CountAllocation(count * size);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* ptr, size_t size)
+    {
+        CountAllocation(size);
+        return __libc_realloc(ptr, size);
+    }
+
+    void free(void* ptr)
+    {
+        __libc_free(ptr);
+    }
+
+    void* memalign(size_t alignment, size_t size)
+    {
+        CountAllocation(size);
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size)
+    {
+        CountAllocation(size);
+        return __libc_memalign(alignment, size);
+    }
+
+    // av_malloc 在支持 posix_memalign 的平台上使用此函数
+    int posix_memalign(void** ptr, size_t alignment, size_t size)
+    {
+        if (0 == alignment || (alignment & (alignment - 1)) || alignment % sizeof(void*))
+        {
+            return EINVAL;
+        }
+
+        CountAllocation(size);
+        void* memory = __libc_memalign(alignment, size);
+        if (!memory)
+        {
+            return ENOMEM;
+        }
+        *ptr = memory;
+
+        return 0;
+    }
+}
+
+AllocationStats CurrentAllocationStats()
+{
+    AllocationStats stats;
+    stats.allocations = g_allocations.load(std::memory_order_relaxed);
+    stats.bytes       = g_bytes.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+size_t PeakRssKilobytes()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+
+    return static_cast<size_t>(usage.ru_maxrss); // Linux 下单位为 KB
+}
+
+size_t CurrentRssKilobytes()
+{
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (!file)
+    {
+        return 0;
+    }
+
+    long total    = 0;
+    long resident = 0;
+    int  fields   = fscanf(file, "%ld %ld", &total, &resident);
+    fclose(file);
+
+    if (fields != 2)
+    {
+        return 0;
+    }
+
+    return static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE)) / 1024U;
+}
@@ -0,0 +1,19 @@
+#ifndef __ALLOC_COUNTER_H__
+#define __ALLOC_COUNTER_H__
+
+#include <cstdint>
+#include <cstddef>
+
+// 基准程序中替换 malloc 系列函数(转发到 glibc 的 __libc_* 实现)，统计进程内的堆分配次数与字节数，
+// FFmpeg 的 av_malloc 与 C++ 的 operator new 最终都经过这些函数
+struct AllocationStats
+{
+    uint64_t allocations; // malloc/calloc/realloc/memalign 调用次数
+    uint64_t bytes;       // 申请的字节数
+};
+
+AllocationStats CurrentAllocationStats();
+size_t          PeakRssKilobytes(); // 进程启动以来的峰值常驻内存
+size_t          CurrentRssKilobytes();
+
+#endif // __ALLOC_COUNTER_H__
@@ -0,0 +1,1045 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <memory>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+
+#include <audio_encoder_aac.h>
+#include <audio_encoder_mp3.h>
+#include <audio_decoder_aac.h>
+#include <audio_decoder_mp3.h>
+#include <audio_transcoder.h>
+#include <sample_convert.h>
+#include <alloc_counter.h>
+#include <signal_generator.h>
+
+// 编解码基准测试：使用合成信号测量实时率、每帧延迟分位数、每帧堆分配次数与内存占用，结果输出为 JSON。
+// 转码用例对比两条路径：transcode 使用 AudioTranscoder 在内存中直接传递平面帧，
+// transcode_pcm 为原有方式，解码为交错浮点 PCM 后再交给编码器转换回平面格式
+//   AduioBenchmark [--duration 秒] [--signals sine,noise,silence,music] [--quick] [--stats] [--loudness]
+//                  [--silence off|cached|gap] [--idle-streams N] [--max-allocations-per-frame N]
+//                  [--max-extra-allocations-per-frame N] [--output 文件|-]
+// --stats 开启编解码器内置统计，额外输出各阶段耗时，可用于对比统计本身的开销
+// --loudness 解码用例开启内置响度测量，额外输出综合响度与峰值，可与不开启时对比测量的开销
+// --silence 编码用例开启静音检测，额外输出跳过的帧数，silence 信号下可对比耗时与输出字节数
+// --idle-streams 额外为每种编解码器打开 N 个不送入数据的实例，输出每个空闲实例的堆分配字节数、
+//                常驻内存增量与实例自身报告的 MemoryUsage，用于估算单进程可容纳的空闲流数
+// --max-allocations-per-frame 用作回归检查：预热后任一用例的每帧堆分配次数超过 N 时以非零状态退出
+// --max-extra-allocations-per-frame 同样用作回归检查，但以同一用例直接调用 libavcodec 的基准循环为准：
+//                每帧分配次数比基准多出 N 以上时以非零状态退出，基准的测量值输出为 ffmpeg_allocations_per_frame
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+// 预热的帧数：缓冲区池与编码器内部的延迟队列在前几帧内达到稳态，之后才开始统计
+constexpr size_t kWarmupFrames = 16U;
+
+struct BenchmarkOptions
+{
+    double                  duration                  = 10.0; // 每个用例的音频时长(秒)
+    std::vector<SignalType> signals                   = {SignalType::kSine, SignalType::kNoise, SignalType::kSilence,
+                                                         SignalType::kMusic};
+    std::vector<int>        sample_rates              = {44100, 48000};
+    std::vector<int>        channels                  = {1, 2};
+    std::vector<int64_t>    aac_bitrates              = {64000, 128000};
+    std::vector<int64_t>    mp3_bitrates              = {128000, 320000};
+    std::string             output                    = "benchmark.json"; // "-" 表示标准输出
+    bool                    stats                     = false;
+    bool                    loudness                  = false;
+    SilenceMode             silence                   = SilenceMode::kOff;
+    size_t                  idle_streams              = 0U;   // 0 表示不测量空闲实例
+    double                  max_allocations_per_frame = -1.0; // 小于 0 表示不检查
+    double                  max_extra_allocations     = -1.0; // 相对 FFmpeg 基准的每帧分配次数上限，小于 0 表示不检查
+};
+
+enum class BenchmarkMode
+{
+    kEncode,
+    kDecode,
+    kTranscode,   // AudioTranscoder，codec 为输入编码，输出为另一种编码
+    kTranscodePcm // 解码为交错 PCM 再编码
+};
+
+struct BenchmarkCase
+{
+    AudioCodecType codec;
+    BenchmarkMode  mode;
+    SignalType     signal;
+    int            sample_rate;
+    int            channels;
+    int64_t        bitrate;
+    bool           stats;
+    bool           loudness;
+    SilenceMode    silence;
+    bool           baseline; // 同时测量 FFmpeg 基准循环的每帧分配次数
+};
+
+struct BenchmarkResult
+{
+    bool               ok                    = false;
+    size_t             frames                = 0;   // 计时的调用次数(编码为每次一帧PCM，解码为每次一个数据包)
+    double             audio_seconds         = 0.0;
+    double             timed_seconds         = 0.0; // 计时区间内处理的音频时长，不含预热与 Flush
+    double             wall_seconds          = 0.0; // 不含构造与预热
+    double             p50_us                = 0.0;
+    double             p99_us                = 0.0;
+    double             max_us                = 0.0;
+    double             allocations_per_frame = 0.0;
+    double             bytes_per_frame       = 0.0;
+    size_t             rss_delta_kb          = 0;
+    size_t             peak_rss_kb           = 0;
+    uint64_t           output_bytes          = 0;
+    bool               has_stats             = false; // 仅 --stats 时有效
+    CodecStatsSnapshot stats                 = {};
+    bool               has_loudness          = false; // 仅 --loudness 的解码用例有效
+    LoudnessSnapshot   loudness              = {};
+    uint64_t           skipped_frames        = 0; // 仅开启 --silence 的编码用例有效
+    double             baseline_allocations  = 0.0; // FFmpeg 基准循环的每帧分配次数，仅 baseline 用例有效
+};
+
+// 记录每帧耗时，结束后排序求分位数；容量预先分配，避免测量过程本身产生堆分配
+class LatencyRecorder
+{
+public:
+    explicit LatencyRecorder(size_t capacity)
+    {
+        samples_.reserve(capacity);
+    }
+
+    void Add(Clock::duration elapsed)
+    {
+        samples_.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+    }
+
+    void Fill(BenchmarkResult& result)
+    {
+        if (samples_.empty())
+        {
+            return;
+        }
+
+        std::sort(samples_.begin(), samples_.end());
+        result.p50_us = Percentile(0.50);
+        result.p99_us = Percentile(0.99);
+        result.max_us = samples_.back();
+    }
+
+private:
+    double Percentile(double ratio) const
+    {
+        size_t index = static_cast<size_t>(ratio * static_cast<double>(samples_.size() - 1) + 0.5);
+        return samples_[std::min(index, samples_.size() - 1)];
+    }
+
+private:
+    std::vector<double> samples_;
+};
+
+// 测量区间：记录起止时刻的分配计数与常驻内存
+class MeasureScope
+{
+public:
+    MeasureScope()
+        : allocations_(CurrentAllocationStats())
+        , rss_kb_(CurrentRssKilobytes())
+        , start_(Clock::now())
+    {
+    }
+
+    void Finish(BenchmarkResult& result) const
+    {
+        Clock::time_point end   = Clock::now();
+        AllocationStats   stats = CurrentAllocationStats();
+        size_t            rss   = CurrentRssKilobytes();
+        double            count = std::max<double>(1.0, static_cast<double>(result.frames));
+
+        result.wall_seconds          = std::chrono::duration<double>(end - start_).count();
+        result.allocations_per_frame = static_cast<double>(stats.allocations - allocations_.allocations) / count;
+        result.bytes_per_frame       = static_cast<double>(stats.bytes - allocations_.bytes) / count;
+        result.rss_delta_kb          = rss > rss_kb_ ? rss - rss_kb_ : 0;
+        result.peak_rss_kb           = PeakRssKilobytes();
+    }
+
+private:
+    AllocationStats   allocations_;
+    size_t            rss_kb_;
+    Clock::time_point start_;
+};
+
+const char* CodecName(AudioCodecType codec)
+{
+    return AudioCodecType::kAAC == codec ? "aac" : "mp3";
+}
+
+const char* ModeName(BenchmarkMode mode)
+{
+    switch (mode)
+    {
+    case BenchmarkMode::kEncode:
+        return "encode";
+    case BenchmarkMode::kDecode:
+        return "decode";
+    case BenchmarkMode::kTranscode:
+        return "transcode";
+    default:
+        return "transcode_pcm";
+    }
+}
+
+bool IsTranscode(BenchmarkMode mode)
+{
+    return BenchmarkMode::kTranscode == mode || BenchmarkMode::kTranscodePcm == mode;
+}
+
+AudioCodecType OtherCodec(AudioCodecType codec)
+{
+    return AudioCodecType::kAAC == codec ? AudioCodecType::kMP3 : AudioCodecType::kAAC;
+}
+
+// 转码用例的输入码流固定使用各编码的高码率
+int64_t TranscodeSourceBitrate(AudioCodecType codec)
+{
+    return AudioCodecType::kAAC == codec ? 128000 : 320000;
+}
+
+// FFmpeg 基准循环：直接调用 libavcodec 的 send/receive，输入输出使用与本工程相同的池化缓冲区，
+// 不经过 FIFO、格式转换、静音检测与回调等封装层。预热后剩下的每帧分配都发生在 libavcodec 内部
+// (从 AVBufferPool 取缓冲区时的 AVBufferRef、send 时对帧/包的内部引用等，次数随 FFmpeg 版本变化)，
+// 封装层的目标是在此之上每帧零分配
+struct FFmpegBaseline
+{
+    bool   ok                    = false;
+    double allocations_per_frame = 0.0; // 每次 send 的分配次数
+    double samples_per_frame     = 0.0; // 每次 send 对应的样本数(每声道)：编码为帧长，解码为每个包的输出样本数
+};
+
+AVCodecContext* OpenBaselineCodec(AudioCodecType codec, bool encoder, const BenchmarkCase& test, PacketBufferPool& pool)
+{
+    AVCodecID       codec_id = AudioCodecType::kAAC == codec ? AV_CODEC_ID_AAC : AV_CODEC_ID_MP3;
+    const AVCodec*  found    = encoder ? avcodec_find_encoder(codec_id) : avcodec_find_decoder(codec_id);
+    AVCodecContext* context  = found ? avcodec_alloc_context3(found) : nullptr;
+    if (!context)
+    {
+        return nullptr;
+    }
+
+    if (encoder)
+    {
+        // 与 AudioEncoderAAC/AudioEncoderMP3 的参数一致
+        context->bit_rate       = test.bitrate;
+        context->sample_fmt     = AudioCodecType::kAAC == codec ? AV_SAMPLE_FMT_FLTP : AV_SAMPLE_FMT_S16P;
+        context->sample_rate    = test.sample_rate;
+        context->channel_layout = (2 == test.channels) ? AV_CH_LAYOUT_STEREO : AV_CH_LAYOUT_MONO;
+        context->channels       = test.channels;
+        pool.InstallEncodeBuffer(context);
+    }
+    else if (AudioCodecType::kAAC == codec)
+    {
+        // 输入为不带 ADTS 头的原始负载，与 AudioDecoderAAC 相同地按用例参数生成 AudioSpecificConfig
+        static const int sample_rates[] = {96000, 88200, 64000, 48000, 44100, 32000, 24000,
+                                           22050, 16000, 12000, 11025, 8000,  7350};
+
+        int frequency_index = 4;
+        for (int i = 0; i < 13; ++i)
+        {
+            if (sample_rates[i] == test.sample_rate)
+            {
+                frequency_index = i;
+                break;
+            }
+        }
+
+        context->extradata = static_cast<uint8_t*>(av_mallocz(2 + AV_INPUT_BUFFER_PADDING_SIZE));
+        if (context->extradata)
+        {
+            context->extradata[0]   = (2 << 3) | (frequency_index >> 1);
+            context->extradata[1]   = ((frequency_index & 1) << 7) | (test.channels << 3);
+            context->extradata_size = 2;
+        }
+    }
+
+    if (avcodec_open2(context, found, nullptr) < 0)
+    {
+        avcodec_free_context(&context);
+    }
+
+    return context;
+}
+
+// 按帧编码 pcm，帧缓冲区取自 AudioFramePool，输出包的缓冲区取自 PacketBufferPool
+FFmpegBaseline MeasureEncodeBaseline(AudioCodecType codec, const BenchmarkCase& test, const std::vector<float>& pcm)
+{
+    FFmpegBaseline   baseline;
+    PacketBufferPool pool;
+    AVCodecContext*  context = OpenBaselineCodec(codec, true, test, pool);
+    AVFrame*         frame   = av_frame_alloc();
+    AVPacket*        packet  = av_packet_alloc();
+
+    if (context && frame && packet)
+    {
+        int            frame_size = context->frame_size;
+        size_t         frames     = pcm.size() / (static_cast<size_t>(frame_size) * test.channels);
+        AudioFramePool frame_pool(context->sample_fmt, test.channels, frame_size);
+
+        frame->nb_samples     = frame_size;
+        frame->format         = context->sample_fmt;
+        frame->channel_layout = context->channel_layout;
+        frame->sample_rate    = context->sample_rate;
+
+        AllocationStats start = CurrentAllocationStats();
+        bool            ok    = true;
+        for (size_t i = 0; ok && i < frames; ++i)
+        {
+            if (kWarmupFrames == i)
+            {
+                start = CurrentAllocationStats();
+            }
+
+            ok = frame_pool.GetBuffer(frame);
+            if (!ok)
+            {
+                break;
+            }
+
+            const float* src = pcm.data() + i * frame_size * test.channels;
+            if (AV_SAMPLE_FMT_FLTP == context->sample_fmt)
+            {
+                DeinterleaveFloat(src, reinterpret_cast<float* const*>(frame->data), test.channels, frame_size);
+            }
+            else
+            {
+                DeinterleaveFloatToS16(src, reinterpret_cast<int16_t* const*>(frame->data), test.channels, frame_size);
+            }
+            frame->pts = static_cast<int64_t>(i) * frame_size;
+
+            ok = avcodec_send_frame(context, frame) >= 0;
+
+            int ret = 0;
+            while (ok && (ret = avcodec_receive_packet(context, packet)) >= 0)
+            {
+                av_packet_unref(packet);
+            }
+            ok = ok && AVERROR(EAGAIN) == ret;
+        }
+
+        if (ok && frames > kWarmupFrames)
+        {
+            AllocationStats end            = CurrentAllocationStats();
+            baseline.ok                    = true;
+            baseline.allocations_per_frame = static_cast<double>(end.allocations - start.allocations)
+                                             / static_cast<double>(frames - kWarmupFrames);
+            baseline.samples_per_frame     = frame_size;
+        }
+        frame_pool.ReleaseBuffer(frame);
+    }
+
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    avcodec_free_context(&context);
+
+    return baseline;
+}
+
+// 逐包解码，输入数据拷贝到 PacketBufferPool 的缓冲区，输出帧不做格式转换
+FFmpegBaseline MeasureDecodeBaseline(const BenchmarkCase& test, const std::vector<std::vector<uint8_t>>& packets)
+{
+    FFmpegBaseline   baseline;
+    PacketBufferPool pool;
+    AVCodecContext*  context = OpenBaselineCodec(test.codec, false, test, pool);
+    AVFrame*         frame   = av_frame_alloc();
+    AVPacket*        packet  = av_packet_alloc();
+
+    if (context && frame && packet && packets.size() > kWarmupFrames)
+    {
+        AllocationStats start   = CurrentAllocationStats();
+        uint64_t        samples = 0;
+        bool            ok      = true;
+        for (size_t i = 0; ok && i < packets.size(); ++i)
+        {
+            if (kWarmupFrames == i)
+            {
+                start = CurrentAllocationStats();
+            }
+
+            ok = pool.Fill(packet, packets[i].data(), packets[i].size() - AV_INPUT_BUFFER_PADDING_SIZE)
+                 && avcodec_send_packet(context, packet) >= 0;
+
+            int ret = 0;
+            while (ok && (ret = avcodec_receive_frame(context, frame)) >= 0)
+            {
+                samples += frame->nb_samples;
+                av_frame_unref(frame);
+            }
+            ok = ok && AVERROR(EAGAIN) == ret;
+        }
+
+        if (ok)
+        {
+            AllocationStats end            = CurrentAllocationStats();
+            baseline.ok                    = true;
+            baseline.allocations_per_frame = static_cast<double>(end.allocations - start.allocations)
+                                             / static_cast<double>(packets.size() - kWarmupFrames);
+            baseline.samples_per_frame     = static_cast<double>(samples) / static_cast<double>(packets.size());
+        }
+    }
+
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    avcodec_free_context(&context);
+
+    return baseline;
+}
+
+// 用例对应的基准：编码、解码各自测量；转码每个输入包为解码一次加上按样本数折算的输出编码帧数
+bool MeasureBaseline(const BenchmarkCase& test, const std::vector<float>& pcm,
+                     const std::vector<std::vector<uint8_t>>& packets, double& allocations_per_frame)
+{
+    if (BenchmarkMode::kEncode == test.mode)
+    {
+        FFmpegBaseline encode = MeasureEncodeBaseline(test.codec, test, pcm);
+        allocations_per_frame = encode.allocations_per_frame;
+        return encode.ok;
+    }
+
+    FFmpegBaseline decode = MeasureDecodeBaseline(test, packets);
+    allocations_per_frame = decode.allocations_per_frame;
+    if (!decode.ok || BenchmarkMode::kDecode == test.mode)
+    {
+        return decode.ok;
+    }
+
+    FFmpegBaseline encode = MeasureEncodeBaseline(OtherCodec(test.codec), test, pcm);
+    allocations_per_frame += encode.allocations_per_frame * decode.samples_per_frame / encode.samples_per_frame;
+    return encode.ok;
+}
+
+template <typename Encoder>
+std::shared_ptr<Encoder> CreateEncoder(const BenchmarkCase& test, const SilenceConfig& silence);
+
+template <>
+std::shared_ptr<AudioEncoderAAC> CreateEncoder<AudioEncoderAAC>(const BenchmarkCase& test, const SilenceConfig& silence)
+{
+    return std::make_shared<AudioEncoderAAC>(test.bitrate, test.sample_rate, test.channels, true, AudioInputFormat(),
+                                             silence);
+}
+
+template <>
+std::shared_ptr<AudioEncoderMP3> CreateEncoder<AudioEncoderMP3>(const BenchmarkCase& test, const SilenceConfig& silence)
+{
+    return std::make_shared<AudioEncoderMP3>(test.bitrate, test.sample_rate, test.channels, true, AudioInputFormat(),
+                                             silence);
+}
+
+template <typename Encoder>
+bool RunEncode(const BenchmarkCase& test, const std::vector<float>& pcm, BenchmarkResult& result)
+{
+    SilenceConfig silence;
+    silence.mode = test.silence;
+
+    std::shared_ptr<Encoder> encoder = CreateEncoder<Encoder>(test, silence);
+    encoder->EnableStats(test.stats);
+
+    uint64_t output_bytes = 0;
+    encoder->InstallPacketCallback([&output_bytes](EncodedPacket&& packet) { output_bytes += packet.Size(); });
+
+    size_t frame_samples = static_cast<size_t>(encoder->FrameSize());
+    size_t frame_bytes   = frame_samples * test.channels * sizeof(float);
+    size_t total_bytes   = pcm.size() * sizeof(float);
+    auto   data          = reinterpret_cast<const uint8_t*>(pcm.data());
+
+    // 预热若干帧，使编码器完成首帧相关的初始化、缓冲区池填满，不计入统计
+    size_t warmup_bytes = std::min(frame_bytes * kWarmupFrames, total_bytes);
+    for (size_t offset = 0; offset < warmup_bytes; offset += frame_bytes)
+    {
+        if (!encoder->Encode(data + offset, std::min(frame_bytes, warmup_bytes - offset)))
+        {
+            return false;
+        }
+    }
+
+    LatencyRecorder latency(total_bytes / frame_bytes + 1);
+    MeasureScope    scope;
+
+    for (size_t offset = warmup_bytes; offset < total_bytes; offset += frame_bytes)
+    {
+        size_t            size  = std::min(frame_bytes, total_bytes - offset);
+        Clock::time_point begin = Clock::now();
+        if (!encoder->Encode(data + offset, size))
+        {
+            return false;
+        }
+        latency.Add(Clock::now() - begin);
+        ++result.frames;
+    }
+
+    // 只统计稳态编码，Flush 不计入
+    scope.Finish(result);
+    result.timed_seconds =
+        static_cast<double>(total_bytes - warmup_bytes) / (sizeof(float) * test.channels) / test.sample_rate;
+    if (!encoder->Flush())
+    {
+        return false;
+    }
+
+    latency.Fill(result);
+    result.output_bytes   = output_bytes;
+    result.has_stats      = encoder->GetStats(result.stats);
+    result.skipped_frames = encoder->SkippedFrames();
+
+    return true;
+}
+
+// 先编码得到数据包序列(不计时)，AAC 只保留原始负载，解码器通过 AudioSpecificConfig 配置；
+// 每个包尾部保留解码器要求的填充字节
+template <typename Encoder>
+bool EncodePackets(const BenchmarkCase& test, const std::vector<float>& pcm, std::vector<std::vector<uint8_t>>& packets)
+{
+    Encoder encoder(test.bitrate, test.sample_rate, test.channels);
+    encoder.InstallPacketCallback([&packets](EncodedPacket&& packet) {
+        std::vector<uint8_t> bytes(packet.Size() + AV_INPUT_BUFFER_PADDING_SIZE, 0);
+        std::copy(packet.Data(), packet.Data() + packet.Size(), bytes.begin());
+        packets.push_back(std::move(bytes));
+    });
+
+    return encoder.Encode(reinterpret_cast<const uint8_t*>(pcm.data()), pcm.size() * sizeof(float))
+           && encoder.Flush();
+}
+
+// 预热后逐包处理并计时，process 返回 false 时中止
+bool ProcessPackets(const std::vector<std::vector<uint8_t>>& packets, BenchmarkResult& result,
+                    const std::function<bool(const uint8_t*, size_t)>& process)
+{
+    size_t warmup = std::min(kWarmupFrames, packets.size());
+    if (0U == warmup)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < warmup; ++i)
+    {
+        if (!process(packets[i].data(), packets[i].size() - AV_INPUT_BUFFER_PADDING_SIZE))
+        {
+            return false;
+        }
+    }
+
+    LatencyRecorder latency(packets.size());
+    MeasureScope    scope;
+
+    for (size_t i = warmup; i < packets.size(); ++i)
+    {
+        Clock::time_point begin = Clock::now();
+        if (!process(packets[i].data(), packets[i].size() - AV_INPUT_BUFFER_PADDING_SIZE))
+        {
+            return false;
+        }
+        latency.Add(Clock::now() - begin);
+        ++result.frames;
+    }
+
+    scope.Finish(result);
+    latency.Fill(result);
+
+    // 每个数据包对应的时长相同，按计时的包数所占比例折算
+    result.timed_seconds =
+        result.audio_seconds * static_cast<double>(packets.size() - warmup) / static_cast<double>(packets.size());
+
+    return true;
+}
+
+template <typename Decoder>
+bool RunDecode(const BenchmarkCase& test, std::shared_ptr<Decoder> decoder,
+               const std::vector<std::vector<uint8_t>>& packets, BenchmarkResult& result)
+{
+    decoder->EnableStats(test.stats);
+    decoder->EnableLoudness(test.loudness);
+
+    uint64_t output_bytes = 0;
+    decoder->InstallFrameCallback([&output_bytes](const AudioFrameView& frame) {
+        output_bytes += frame.plane_size * frame.planes;
+    });
+
+    if (!ProcessPackets(packets, result,
+                        [&decoder](const uint8_t* data, size_t size) { return decoder->Decode(data, size); }))
+    {
+        return false;
+    }
+
+    result.output_bytes = output_bytes;
+    result.has_stats    = decoder->GetStats(result.stats);
+    result.has_loudness = decoder->GetLoudness(result.loudness);
+
+    return output_bytes > 0;
+}
+
+bool RunTranscode(const BenchmarkCase& test, const std::vector<std::vector<uint8_t>>& packets,
+                  BenchmarkResult& result)
+{
+    // AAC 输入为不带 ADTS 头的原始负载，按用例参数生成 AudioSpecificConfig
+    AudioTranscoder transcoder(test.codec, OtherCodec(test.codec), test.bitrate, test.sample_rate, test.channels);
+
+    uint64_t output_bytes = 0;
+    transcoder.InstallPacketCallback([&output_bytes](EncodedPacket&& packet) { output_bytes += packet.Size(); });
+
+    if (!ProcessPackets(packets, result, [&transcoder](const uint8_t* data, size_t size) {
+            return transcoder.Transcode(data, size);
+        }))
+    {
+        return false;
+    }
+
+    if (!transcoder.Flush())
+    {
+        return false;
+    }
+    result.output_bytes = output_bytes;
+
+    return output_bytes > 0;
+}
+
+template <typename Decoder, typename Encoder>
+bool RunTranscodePcm(const BenchmarkCase& test, std::shared_ptr<Decoder> decoder,
+                     const std::vector<std::vector<uint8_t>>& packets, BenchmarkResult& result)
+{
+    Encoder encoder(test.bitrate, test.sample_rate, test.channels);
+
+    uint64_t output_bytes = 0;
+    encoder.InstallPacketCallback([&output_bytes](EncodedPacket&& packet) { output_bytes += packet.Size(); });
+
+    // 解码器输出交错浮点 PCM，由编码器转换回平面格式
+    bool encoded = true;
+    decoder->InstallCallback([&encoder, &encoded](uint8_t* data, uint32_t size) {
+        encoded = encoder.Encode(data, size) && encoded;
+    });
+
+    if (!ProcessPackets(packets, result, [&decoder, &encoded](const uint8_t* data, size_t size) {
+            return decoder->Decode(data, size) && encoded;
+        }))
+    {
+        return false;
+    }
+
+    if (!encoder.Flush())
+    {
+        return false;
+    }
+    result.output_bytes = output_bytes;
+
+    return output_bytes > 0;
+}
+
+BenchmarkResult RunCase(const BenchmarkCase& test, double duration)
+{
+    BenchmarkResult result;
+    size_t          samples = static_cast<size_t>(duration * test.sample_rate);
+    result.audio_seconds    = static_cast<double>(samples) / test.sample_rate;
+
+    std::vector<float>                pcm = GenerateSignal(test.signal, test.sample_rate, test.channels, samples);
+    std::vector<std::vector<uint8_t>> packets;
+
+    try
+    {
+        if (BenchmarkMode::kEncode == test.mode)
+        {
+            result.ok = AudioCodecType::kAAC == test.codec ? RunEncode<AudioEncoderAAC>(test, pcm, result)
+                                                           : RunEncode<AudioEncoderMP3>(test, pcm, result);
+        }
+        else
+        {
+            // 转码用例先按固定码率编码输入码流，用例的码率用于输出
+            BenchmarkCase source = test;
+            if (IsTranscode(test.mode))
+            {
+                source.bitrate = TranscodeSourceBitrate(test.codec);
+            }
+
+            bool encoded = AudioCodecType::kAAC == test.codec ? EncodePackets<AudioEncoderAAC>(source, pcm, packets)
+                                                              : EncodePackets<AudioEncoderMP3>(source, pcm, packets);
+
+            if (!encoded)
+            {
+                result.ok = false;
+            }
+            else if (BenchmarkMode::kTranscode == test.mode)
+            {
+                result.ok = RunTranscode(test, packets, result);
+            }
+            else if (AudioCodecType::kAAC == test.codec)
+            {
+                std::shared_ptr<AudioDecoderAAC> decoder =
+                    std::make_shared<AudioDecoderAAC>(AudioOutputFormat(), test.sample_rate, test.channels);
+                result.ok = BenchmarkMode::kDecode == test.mode
+                                ? RunDecode(test, decoder, packets, result)
+                                : RunTranscodePcm<AudioDecoderAAC, AudioEncoderMP3>(test, decoder, packets, result);
+            }
+            else
+            {
+                std::shared_ptr<AudioDecoderMP3> decoder = std::make_shared<AudioDecoderMP3>();
+                result.ok = BenchmarkMode::kDecode == test.mode
+                                ? RunDecode(test, decoder, packets, result)
+                                : RunTranscodePcm<AudioDecoderMP3, AudioEncoderAAC>(test, decoder, packets, result);
+            }
+        }
+
+        if (result.ok && test.baseline && !MeasureBaseline(test, pcm, packets, result.baseline_allocations))
+        {
+            std::cerr << "Could not measure the FFmpeg baseline" << std::endl;
+            result.ok = false;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Benchmark case failed: " << e.what() << std::endl;
+        result.ok = false;
+    }
+
+    return result;
+}
+
+struct IdleResult
+{
+    const char* kind;
+    size_t      streams;
+    bool        ok;
+    double      allocated_bytes_per_stream; // 打开期间申请的堆字节数(含已释放的临时分配)
+    double      rss_bytes_per_stream;
+    size_t      reported_bytes;             // 实例 MemoryUsage().Total()，不含 FFmpeg 内部状态
+};
+
+// 连续打开 streams 个实例并全部保持打开，按实例平均打开前后的分配字节数与常驻内存增量
+template <typename Codec>
+IdleResult MeasureIdle(const char* kind, size_t streams, const std::function<std::unique_ptr<Codec>()>& create)
+{
+    IdleResult result = {kind, streams, true, 0.0, 0.0, 0U};
+
+    std::vector<std::unique_ptr<Codec>> codecs;
+    codecs.reserve(streams);
+
+    AllocationStats before = CurrentAllocationStats();
+    size_t          rss    = CurrentRssKilobytes();
+    try
+    {
+        for (size_t i = 0; i < streams; ++i)
+        {
+            codecs.push_back(create());
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Idle stream measurement failed: " << e.what() << std::endl;
+        result.ok = false;
+        return result;
+    }
+    AllocationStats after     = CurrentAllocationStats();
+    size_t          rss_after = CurrentRssKilobytes();
+
+    double count                      = static_cast<double>(streams);
+    result.allocated_bytes_per_stream = static_cast<double>(after.bytes - before.bytes) / count;
+    result.rss_bytes_per_stream       = rss_after > rss ? static_cast<double>(rss_after - rss) * 1024.0 / count : 0.0;
+    result.reported_bytes             = codecs.front()->MemoryUsage().Total();
+
+    return result;
+}
+
+std::vector<IdleResult> RunIdle(const BenchmarkOptions& options)
+{
+    const size_t  streams     = options.idle_streams;
+    const int     sample_rate = options.sample_rates.front();
+    const int     channels    = options.channels.front();
+    const int64_t aac_bitrate = options.aac_bitrates.front();
+    const int64_t mp3_bitrate = options.mp3_bitrates.front();
+
+    std::vector<IdleResult> results;
+    results.push_back(MeasureIdle<AudioEncoderAAC>("aac_encoder", streams, [&]() {
+        return std::unique_ptr<AudioEncoderAAC>(new AudioEncoderAAC(aac_bitrate, sample_rate, channels));
+    }));
+    results.push_back(MeasureIdle<AudioEncoderMP3>("mp3_encoder", streams, [&]() {
+        return std::unique_ptr<AudioEncoderMP3>(new AudioEncoderMP3(mp3_bitrate, sample_rate, channels));
+    }));
+    results.push_back(MeasureIdle<AudioDecoderAAC>("aac_decoder", streams, []() {
+        return std::unique_ptr<AudioDecoderAAC>(new AudioDecoderAAC());
+    }));
+    results.push_back(MeasureIdle<AudioDecoderMP3>("mp3_decoder", streams, []() {
+        return std::unique_ptr<AudioDecoderMP3>(new AudioDecoderMP3());
+    }));
+
+    return results;
+}
+
+void WriteIdleResult(std::ostream& out, const IdleResult& result)
+{
+    out << "    {\"kind\": \"" << result.kind << "\", \"streams\": " << result.streams
+        << ", \"ok\": " << (result.ok ? "true" : "false")
+        << ", \"allocated_bytes_per_stream\": " << result.allocated_bytes_per_stream
+        << ", \"rss_bytes_per_stream\": " << result.rss_bytes_per_stream
+        << ", \"reported_bytes\": " << result.reported_bytes << "}";
+}
+
+void WriteResult(std::ostream& out, const BenchmarkCase& test, const BenchmarkResult& result)
+{
+    // realtime_factor = 处理耗时 / 计时区间内处理的音频时长，越小越快；预热与 Flush 不在计时区间内
+    double processed = result.timed_seconds;
+    double rtf       = processed > 0.0 ? result.wall_seconds / processed : 0.0;
+
+    out << "    {\"codec\": \"" << CodecName(test.codec) << "\", \"mode\": \"" << ModeName(test.mode) << "\", ";
+    if (IsTranscode(test.mode))
+    {
+        out << "\"target\": \"" << CodecName(OtherCodec(test.codec)) << "\", ";
+    }
+    out << "\"signal\": \"" << SignalTypeName(test.signal) << "\", \"sample_rate\": " << test.sample_rate
+        << ", \"channels\": " << test.channels << ", \"bitrate\": " << test.bitrate
+        << ", \"ok\": " << (result.ok ? "true" : "false") << ", \"frames\": " << result.frames
+        << ", \"audio_seconds\": " << result.audio_seconds << ", \"timed_seconds\": " << result.timed_seconds
+        << ", \"wall_seconds\": " << result.wall_seconds
+        << ", \"realtime_factor\": " << rtf << ", \"speed_x\": " << (rtf > 0.0 ? 1.0 / rtf : 0.0)
+        << ", \"latency_us\": {\"p50\": " << result.p50_us << ", \"p99\": " << result.p99_us
+        << ", \"max\": " << result.max_us << "}, \"allocations_per_frame\": " << result.allocations_per_frame
+        << ", \"allocated_bytes_per_frame\": " << result.bytes_per_frame
+        << ", \"rss_delta_kb\": " << result.rss_delta_kb << ", \"peak_rss_kb\": " << result.peak_rss_kb
+        << ", \"output_bytes\": " << result.output_bytes;
+
+    if (test.baseline)
+    {
+        out << ", \"ffmpeg_allocations_per_frame\": " << result.baseline_allocations;
+    }
+
+    if (BenchmarkMode::kEncode == test.mode && SilenceMode::kOff != test.silence)
+    {
+        out << ", \"silence\": \"" << (SilenceMode::kGap == test.silence ? "gap" : "cached")
+            << "\", \"skipped_frames\": " << result.skipped_frames;
+    }
+
+    if (result.has_stats)
+    {
+        const CodecStatsSnapshot& stats = result.stats;
+
+        out << ", \"errors\": " << stats.errors << ", \"stages\": {";
+        for (int i = 0; i < kCodecStageCount; ++i)
+        {
+            CodecStage stage = static_cast<CodecStage>(i);
+            out << (i > 0 ? ", " : "") << "\"" << CodecStageName(stage)
+                << "\": {\"count\": " << stats.stages[i].count << ", \"mean_ns\": " << stats.MeanNanoseconds(stage)
+                << ", \"p99_ns\": " << stats.PercentileNanoseconds(stage, 0.99)
+                << ", \"max_ns\": " << stats.MaxNanoseconds(stage) << "}";
+        }
+        out << "}";
+    }
+
+    if (result.has_loudness)
+    {
+        // 静音的响度为负无穷，JSON 中以 null 表示
+        auto lufs = [](double value) { return std::isfinite(value) ? std::to_string(value) : std::string("null"); };
+
+        const LoudnessSnapshot& loudness = result.loudness;
+        out << ", \"loudness\": {\"integrated_lufs\": " << lufs(loudness.integrated)
+            << ", \"max_momentary_lufs\": " << lufs(loudness.max_momentary)
+            << ", \"max_short_term_lufs\": " << lufs(loudness.max_short_term)
+            << ", \"sample_peak\": " << loudness.sample_peak << ", \"true_peak\": " << loudness.true_peak << "}";
+    }
+    out << "}";
+}
+
+bool ParseOptions(int argc, char* argv[], BenchmarkOptions& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+
+        if ("--duration" == arg && i + 1 < argc)
+        {
+            options.duration = std::stod(argv[++i]);
+        }
+        else if ("--output" == arg && i + 1 < argc)
+        {
+            options.output = argv[++i];
+        }
+        else if ("--signals" == arg && i + 1 < argc)
+        {
+            options.signals.clear();
+            std::stringstream names(argv[++i]);
+            std::string       name;
+            while (std::getline(names, name, ','))
+            {
+                SignalType type;
+                if (!ParseSignalType(name, type))
+                {
+                    std::cerr << "Unknown signal: " << name << std::endl;
+                    return false;
+                }
+                options.signals.push_back(type);
+            }
+        }
+        else if ("--max-allocations-per-frame" == arg && i + 1 < argc)
+        {
+            options.max_allocations_per_frame = std::stod(argv[++i]);
+        }
+        else if ("--max-extra-allocations-per-frame" == arg && i + 1 < argc)
+        {
+            options.max_extra_allocations = std::stod(argv[++i]);
+        }
+        else if ("--stats" == arg)
+        {
+            options.stats = true;
+        }
+        else if ("--loudness" == arg)
+        {
+            options.loudness = true;
+        }
+        else if ("--silence" == arg && i + 1 < argc)
+        {
+            std::string mode = argv[++i];
+            if ("cached" == mode)
+            {
+                options.silence = SilenceMode::kCachedFrame;
+            }
+            else if ("gap" == mode)
+            {
+                options.silence = SilenceMode::kGap;
+            }
+            else if ("off" != mode)
+            {
+                std::cerr << "Unknown silence mode: " << mode << std::endl;
+                return false;
+            }
+        }
+        else if ("--idle-streams" == arg && i + 1 < argc)
+        {
+            options.idle_streams = std::stoul(argv[++i]);
+        }
+        else if ("--quick" == arg)
+        {
+            // 只测 44.1kHz 立体声与每种编码一个码率
+            options.sample_rates = {44100};
+            options.channels     = {2};
+            options.aac_bitrates = {128000};
+            options.mp3_bitrates = {320000};
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--duration seconds] [--signals sine,noise,silence,music] [--quick] [--stats] [--loudness]"
+                      << " [--silence off|cached|gap] [--idle-streams N] [--max-allocations-per-frame N]"
+                      << " [--max-extra-allocations-per-frame N] [--output file|-]"
+                      << std::endl;
+            return false;
+        }
+    }
+
+    return options.duration > 0.0 && !options.signals.empty();
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        return -1;
+    }
+
+    std::vector<BenchmarkCase> cases;
+    for (BenchmarkMode mode :
+         {BenchmarkMode::kEncode, BenchmarkMode::kDecode, BenchmarkMode::kTranscode, BenchmarkMode::kTranscodePcm})
+    {
+        for (AudioCodecType codec : {AudioCodecType::kAAC, AudioCodecType::kMP3})
+        {
+            // 转码用例的码率列表取输出编码的
+            AudioCodecType              output   = IsTranscode(mode) ? OtherCodec(codec) : codec;
+            const std::vector<int64_t>& bitrates =
+                AudioCodecType::kAAC == output ? options.aac_bitrates : options.mp3_bitrates;
+
+            for (SignalType signal : options.signals)
+            {
+                for (int sample_rate : options.sample_rates)
+                {
+                    for (int channels : options.channels)
+                    {
+                        for (int64_t bitrate : bitrates)
+                        {
+                            cases.push_back({codec, mode, signal, sample_rate, channels, bitrate, options.stats,
+                                             options.loudness, options.silence, options.max_extra_allocations >= 0.0});
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // 结果先写入内存，避免编解码器初始化时打印到标准输出的信息混入 JSON
+    std::ostringstream json;
+    json << "{\n  \"kernel\": \"" << SampleConvertKernelName() << "\",\n  \"duration_seconds\": " << options.duration
+         << ",\n  \"results\": [\n";
+
+    int failures = 0;
+    for (size_t i = 0; i < cases.size(); ++i)
+    {
+        const BenchmarkCase& test   = cases[i];
+        BenchmarkResult      result = RunCase(test, options.duration);
+        bool over_limit = result.ok && options.max_allocations_per_frame >= 0.0
+                          && result.allocations_per_frame > options.max_allocations_per_frame;
+        double extra    = result.allocations_per_frame - result.baseline_allocations;
+        bool over_extra = result.ok && test.baseline && extra > options.max_extra_allocations;
+        failures += (result.ok && !over_limit && !over_extra) ? 0 : 1;
+
+        std::cerr << "[" << (i + 1) << "/" << cases.size() << "] " << CodecName(test.codec) << " "
+                  << ModeName(test.mode) << " " << SignalTypeName(test.signal) << " "
+                  << test.sample_rate << "Hz " << test.channels << "ch " << test.bitrate << "bps: "
+                  << (result.ok ? "ok" : "FAILED");
+        if (over_limit)
+        {
+            std::cerr << " (" << result.allocations_per_frame << " allocations per frame exceeds limit "
+                      << options.max_allocations_per_frame << ")";
+        }
+        if (over_extra)
+        {
+            std::cerr << " (" << result.allocations_per_frame << " allocations per frame, FFmpeg baseline "
+                      << result.baseline_allocations << ", " << extra << " above it exceeds limit "
+                      << options.max_extra_allocations << ")";
+        }
+        std::cerr << std::endl;
+
+        WriteResult(json, test, result);
+        json << (i + 1 < cases.size() ? ",\n" : "\n");
+    }
+    json << "  ]";
+
+    if (options.idle_streams > 0U)
+    {
+        std::vector<IdleResult> idle = RunIdle(options);
+
+        json << ",\n  \"idle_streams\": [\n";
+        for (size_t i = 0; i < idle.size(); ++i)
+        {
+            failures += idle[i].ok ? 0 : 1;
+            std::cerr << "idle " << idle[i].kind << " x" << idle[i].streams << ": "
+                      << (idle[i].ok ? "ok" : "FAILED") << std::endl;
+
+            WriteIdleResult(json, idle[i]);
+            json << (i + 1 < idle.size() ? ",\n" : "\n");
+        }
+        json << "  ]";
+    }
+    json << "\n}\n";
+
+    if ("-" == options.output)
+    {
+        std::cout << json.str();
+    }
+    else
+    {
+        std::ofstream file(options.output);
+        if (!file)
+        {
+            std::cerr << "Could not open output file: " << options.output << std::endl;
+            return -1;
+        }
+        file << json.str();
+    }
+
+    return failures > 0 ? 1 : 0;
+}
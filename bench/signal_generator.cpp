@@ -0,0 +1,140 @@
+#include <signal_generator.h>
+
+#include <cmath>
+
+namespace
+{
+constexpr double kPi = 3.14159265358979323846;
+
+// 固定种子的 xorshift32，保证每次生成的噪声相同
+class NoiseSource
+{
+public:
+    explicit NoiseSource(uint32_t seed)
+        : state_(seed ? seed : 0x9E3779B9U)
+    {
+    }
+
+    float Next() // [-1, 1)
+    {
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 17;
+        state_ ^= state_ << 5;
+        return static_cast<float>(state_) * (2.0f / 4294967296.0f) - 1.0f;
+    }
+
+private:
+    uint32_t state_;
+};
+
+void GenerateSine(std::vector<float>& pcm, int sample_rate, int channels, size_t samples)
+{
+    double step = 2.0 * kPi * 1000.0 / sample_rate;
+    for (size_t i = 0; i < samples; ++i)
+    {
+        float value = static_cast<float>(0.5 * std::sin(step * static_cast<double>(i)));
+        for (int c = 0; c < channels; ++c)
+        {
+            pcm[i * channels + c] = value;
+        }
+    }
+}
+
+void GenerateNoise(std::vector<float>& pcm, int channels, size_t samples)
+{
+    NoiseSource noise(12345U);
+    for (size_t i = 0; i < samples * channels; ++i)
+    {
+        pcm[i] = 0.25f * noise.Next();
+    }
+}
+
+void GenerateMusic(std::vector<float>& pcm, int sample_rate, int channels, size_t samples)
+{
+    // 每 250ms 切换一个三和弦(根音、三度、五度带泛音)，每拍开头叠加一段衰减的噪声模拟打击乐
+    static const double kRoots[] = {220.0, 261.63, 196.0, 174.61, 246.94, 293.66, 164.81, 329.63};
+    const size_t        note_length = static_cast<size_t>(sample_rate) / 4;
+
+    NoiseSource noise(54321U);
+    for (size_t i = 0; i < samples; ++i)
+    {
+        size_t note     = i / note_length;
+        size_t position = i % note_length;
+        double root     = kRoots[note % (sizeof(kRoots) / sizeof(kRoots[0]))];
+        double t        = static_cast<double>(i) / sample_rate;
+        double envelope = std::exp(-3.0 * static_cast<double>(position) / note_length);
+
+        double tone = 0.0;
+        for (double ratio : {1.0, 1.25, 1.5})
+        {
+            double frequency = root * ratio;
+            tone += std::sin(2.0 * kPi * frequency * t) + 0.3 * std::sin(4.0 * kPi * frequency * t)
+                    + 0.1 * std::sin(6.0 * kPi * frequency * t);
+        }
+        tone *= 0.12 * envelope;
+
+        double drum = (note % 2 == 0) ? std::exp(-40.0 * static_cast<double>(position) / note_length) : 0.0;
+        float  hit  = static_cast<float>(0.3 * drum) * noise.Next();
+
+        // 声道间幅度略有差异，避免立体声编码退化为单声道
+        for (int c = 0; c < channels; ++c)
+        {
+            double pan            = 1.0 - 0.15 * c;
+            pcm[i * channels + c] = static_cast<float>(tone * pan) + hit;
+        }
+    }
+}
+} // namespace
+
+const char* SignalTypeName(SignalType type)
+{
+    switch (type)
+    {
+    case SignalType::kSine:
+        return "sine";
+    case SignalType::kNoise:
+        return "noise";
+    case SignalType::kSilence:
+        return "silence";
+    case SignalType::kMusic:
+        return "music";
+    }
+
+    return "unknown";
+}
+
+bool ParseSignalType(const std::string& name, SignalType& type)
+{
+    for (SignalType candidate : {SignalType::kSine, SignalType::kNoise, SignalType::kSilence, SignalType::kMusic})
+    {
+        if (name == SignalTypeName(candidate))
+        {
+            type = candidate;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::vector<float> GenerateSignal(SignalType type, int sample_rate, int channels, size_t samples)
+{
+    std::vector<float> pcm(samples * channels, 0.0f);
+
+    switch (type)
+    {
+    case SignalType::kSine:
+        GenerateSine(pcm, sample_rate, channels, samples);
+        break;
+    case SignalType::kNoise:
+        GenerateNoise(pcm, channels, samples);
+        break;
+    case SignalType::kSilence:
+        break;
+    case SignalType::kMusic:
+        GenerateMusic(pcm, sample_rate, channels, samples);
+        break;
+    }
+
+    return pcm;
+}
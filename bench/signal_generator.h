@@ -0,0 +1,23 @@
+#ifndef __SIGNAL_GENERATOR_H__
+#define __SIGNAL_GENERATOR_H__
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// 基准测试使用的合成信号，统一输出交错浮点PCM，幅度在 [-1, 1] 内
+enum class SignalType
+{
+    kSine,    // 1kHz 正弦，-6dBFS
+    kNoise,   // 白噪声，-12dBFS
+    kSilence, // 全零
+    kMusic,   // 和弦音符序列 + 打击乐噪声，包络与频谱随时间变化，接近真实音乐的编码负载
+};
+
+const char* SignalTypeName(SignalType type);
+bool        ParseSignalType(const std::string& name, SignalType& type);
+
+// 生成 samples 个样本(每声道)的交错浮点PCM，相同参数的输出完全一致，便于不同版本之间对比
+std::vector<float> GenerateSignal(SignalType type, int sample_rate, int channels, size_t samples);
+
+#endif // __SIGNAL_GENERATOR_H__
@@ -0,0 +1,224 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+
+#include <file_sink.h>
+
+// 文件输出基准：以 ADTS 大小的数据包(头部 + 负载)写出同样的码流，对比三种写法的吞吐，结果输出为 JSON。
+//   fopen_per_packet 为原有方式，每个包都以 ab+ 打开、写入、关闭文件；
+//   sync 为 FileSink 的用户态缓冲区 + writev；async 额外开启双缓冲后台刷新线程。
+// 三个输出文件写完后逐字节比较，内容不一致时以非零状态退出
+//   AduioSinkBenchmark [--packets N] [--header 字节] [--payload 字节] [--dir 目录] [--output 文件|-]
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct SinkOptions
+{
+    size_t      packets = 200000U;
+    size_t      header  = 7U;   // ADTS 头
+    size_t      payload = 380U; // 128kbps 44.1kHz AAC 的平均帧长
+    std::string dir     = ".";
+    std::string output  = "-";
+};
+
+struct SinkResult
+{
+    const char* mode;
+    std::string path;
+    bool        ok;
+    double      seconds;
+    uint64_t    bytes;
+};
+
+// 数据包内容随序号变化，避免文件内容比较时错位也能相同
+void FillPacket(size_t index, std::vector<uint8_t>& header, std::vector<uint8_t>& payload)
+{
+    for (size_t i = 0; i < header.size(); ++i)
+    {
+        header[i] = static_cast<uint8_t>(0xF0 + i + index);
+    }
+    for (size_t i = 0; i < payload.size(); ++i)
+    {
+        payload[i] = static_cast<uint8_t>(i * 31 + index * 7);
+    }
+}
+
+SinkResult RunMode(const char* mode, const SinkOptions& options, const std::function<bool(const std::string&)>& run)
+{
+    SinkResult result = {mode, options.dir + "/sink_" + mode + ".bin", false, 0.0, 0U};
+
+    // 清空上次的输出，fopen_per_packet 以追加方式写入
+    std::remove(result.path.c_str());
+
+    Clock::time_point start = Clock::now();
+    result.ok               = run(result.path);
+    result.seconds          = std::chrono::duration<double>(Clock::now() - start).count();
+    result.bytes            = static_cast<uint64_t>(options.packets) * (options.header + options.payload);
+
+    return result;
+}
+
+bool SameContent(const std::string& a, const std::string& b)
+{
+    std::ifstream fa(a, std::ios::binary);
+    std::ifstream fb(b, std::ios::binary);
+    if (!fa || !fb)
+    {
+        return false;
+    }
+
+    std::istreambuf_iterator<char> ia(fa), ib(fb), end;
+    for (; ia != end && ib != end; ++ia, ++ib)
+    {
+        if (*ia != *ib)
+        {
+            return false;
+        }
+    }
+
+    return ia == end && ib == end;
+}
+
+bool ParseOptions(int argc, char* argv[], SinkOptions& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+
+        if ("--packets" == arg && i + 1 < argc)
+        {
+            options.packets = std::stoul(argv[++i]);
+        }
+        else if ("--header" == arg && i + 1 < argc)
+        {
+            options.header = std::stoul(argv[++i]);
+        }
+        else if ("--payload" == arg && i + 1 < argc)
+        {
+            options.payload = std::stoul(argv[++i]);
+        }
+        else if ("--dir" == arg && i + 1 < argc)
+        {
+            options.dir = argv[++i];
+        }
+        else if ("--output" == arg && i + 1 < argc)
+        {
+            options.output = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--packets N] [--header bytes] [--payload bytes] [--dir directory] [--output file|-]"
+                      << std::endl;
+            return false;
+        }
+    }
+
+    return options.packets > 0U && options.payload > 0U;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    SinkOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        return -1;
+    }
+
+    std::vector<uint8_t> header(options.header);
+    std::vector<uint8_t> payload(options.payload);
+
+    std::vector<SinkResult> results;
+
+    results.push_back(RunMode("fopen_per_packet", options, [&](const std::string& path) {
+        for (size_t i = 0; i < options.packets; ++i)
+        {
+            FillPacket(i, header, payload);
+
+            FILE* file = fopen(path.c_str(), "ab+");
+            if (!file)
+            {
+                return false;
+            }
+            fwrite(header.data(), 1, header.size(), file);
+            fwrite(payload.data(), 1, payload.size(), file);
+            fclose(file);
+        }
+        return true;
+    }));
+
+    for (bool async_flush : {false, true})
+    {
+        results.push_back(RunMode(async_flush ? "async" : "sync", options, [&](const std::string& path) {
+            FileSink sink(path, FileSink::kDefaultBufferSize, async_flush);
+            for (size_t i = 0; i < options.packets; ++i)
+            {
+                FillPacket(i, header, payload);
+                if (!sink.Write(header.data(), header.size(), payload.data(), payload.size()))
+                {
+                    return false;
+                }
+            }
+            // 关闭计入耗时，保证数据已全部交给内核
+            return sink.Close();
+        }));
+    }
+
+    bool identical = true;
+    for (size_t i = 1; i < results.size(); ++i)
+    {
+        identical = identical && SameContent(results[0].path, results[i].path);
+    }
+
+    std::ostringstream json;
+    json << "{\n  \"packets\": " << options.packets << ",\n  \"packet_bytes\": " << options.header + options.payload
+         << ",\n  \"identical\": " << (identical ? "true" : "false") << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const SinkResult& result = results[i];
+        double            mbps   = result.seconds > 0.0 ? result.bytes / result.seconds / 1e6 : 0.0;
+
+        json << "    {\"mode\": \"" << result.mode << "\", \"ok\": " << (result.ok ? "true" : "false")
+             << ", \"seconds\": " << result.seconds << ", \"megabytes_per_second\": " << mbps << "}"
+             << (i + 1 < results.size() ? ",\n" : "\n");
+
+        std::cerr << result.mode << ": " << (result.ok ? "ok" : "FAILED") << " " << result.seconds << " s " << mbps
+                  << " MB/s" << std::endl;
+    }
+    json << "  ]\n}\n";
+
+    if ("-" == options.output)
+    {
+        std::cout << json.str();
+    }
+    else
+    {
+        std::ofstream file(options.output);
+        if (!file)
+        {
+            std::cerr << "Could not open output file: " << options.output << std::endl;
+            return -1;
+        }
+        file << json.str();
+    }
+
+    for (const SinkResult& result : results)
+    {
+        std::remove(result.path.c_str());
+        if (!result.ok)
+        {
+            return 1;
+        }
+    }
+
+    return identical ? 0 : 1;
+}
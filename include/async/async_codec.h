@@ -0,0 +1,221 @@
+#ifndef __ASYNC_CODEC_H__
+#define __ASYNC_CODEC_H__
+
+#include <algorithm>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <async_executor.h>
+#include <async_task.h>
+#include <encoded_packet.h>
+
+// 一次异步编码的结果：ok 为 false 时 packets 中是出错前已输出的数据包
+struct AsyncEncodeResult
+{
+    bool                       ok;
+    std::vector<EncodedPacket> packets;
+};
+
+// 可 co_await 的异步操作：挂起时把 work 投递到流的串行序列上执行，完成后由执行器恢复协程并返回 work 的结果。
+// 操作对象位于等待方的协程帧中，挂起期间一直有效
+template <typename Result>
+class AsyncOperation
+{
+private:
+    using WorkType = std::function<Result()>;
+
+public:
+    AsyncOperation(AsyncStrand& strand, WorkType work)
+        : strand_(strand)
+        , work_(std::move(work))
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        strand_.Post([this, handle]() {
+            AsyncExecutor& executor = strand_.Executor();
+            try
+            {
+                result_.emplace(work_());
+            }
+            catch (...)
+            {
+                exception_ = std::current_exception();
+            }
+
+            // 恢复后协程可能立即结束并销毁本对象，之后不再访问成员
+            executor.Resume(handle);
+        });
+    }
+
+    Result await_resume()
+    {
+        if (exception_)
+        {
+            std::rethrow_exception(exception_);
+        }
+        return std::move(*result_);
+    }
+
+private:
+    AsyncStrand&          strand_;
+    WorkType              work_;
+    std::optional<Result> result_;
+    std::exception_ptr    exception_;
+};
+
+// 编码器的协程接口，与回调接口并存：包装一个 AudioEncoderAAC/AudioEncoderMP3 实例(可来自 AudioCodecFactory)，
+// 编码在执行器的线程池上进行，调用方协程在此期间挂起而不阻塞所在线程。
+// 包装期间由本对象占用编码器的回调，同一实例上的异步操作按发起顺序执行；
+// 有未完成的操作时不可销毁本对象，输入数据在操作完成前须保持有效
+template <typename Encoder>
+class AsyncEncoder
+{
+public:
+    AsyncEncoder(AsyncExecutor& executor, std::shared_ptr<Encoder> encoder)
+        : encoder_(std::move(encoder))
+        , strand_(executor)
+    {
+        if (!encoder_)
+        {
+            throw std::runtime_error("Encoder is null");
+        }
+
+        encoder_->ClearCallbacks();
+        encoder_->InstallPacketCallback([this](EncodedPacket&& packet) { packets_.push_back(std::move(packet)); });
+    }
+
+    ~AsyncEncoder()
+    {
+        encoder_->ClearCallbacks();
+    }
+
+    AsyncEncoder(const AsyncEncoder&)            = delete;
+    AsyncEncoder& operator=(const AsyncEncoder&) = delete;
+
+    // co_await EncodeAsync(data) 得到本次输入凑满的帧编码出的数据包
+    AsyncOperation<AsyncEncodeResult> EncodeAsync(std::span<const uint8_t> data)
+    {
+        return AsyncOperation<AsyncEncodeResult>(strand_, [this, data]() {
+            bool ok = encoder_->Encode(data.data(), data.size());
+            return TakePackets(ok);
+        });
+    }
+
+    AsyncOperation<AsyncEncodeResult> FlushAsync()
+    {
+        return AsyncOperation<AsyncEncodeResult>(strand_, [this]() {
+            bool ok = encoder_->Flush();
+            return TakePackets(ok);
+        });
+    }
+
+    // 异步生成器：data 按 chunk_size 字节(0 表示整体)分块编码，最后冲刷编码器，逐个产出数据包。
+    // 编码失败时抛出 std::runtime_error，由 co_await Next() 重新抛出
+    AsyncGenerator<EncodedPacket> Packets(std::span<const uint8_t> data, size_t chunk_size = 0)
+    {
+        if (0 == chunk_size)
+        {
+            chunk_size = std::max<size_t>(data.size(), 1U);
+        }
+
+        bool   flushed = false;
+        size_t offset  = 0;
+        while (!flushed)
+        {
+            AsyncEncodeResult result;
+            if (offset < data.size())
+            {
+                size_t size = std::min(chunk_size, data.size() - offset);
+                result      = co_await EncodeAsync(data.subspan(offset, size));
+                offset += size;
+            }
+            else
+            {
+                result  = co_await FlushAsync();
+                flushed = true;
+            }
+
+            for (EncodedPacket& packet : result.packets)
+            {
+                co_yield std::move(packet);
+            }
+
+            if (!result.ok)
+            {
+                throw std::runtime_error("Failed to encode audio");
+            }
+        }
+    }
+
+    Encoder& Codec() // 用于统计等不与异步操作并发的调用
+    {
+        return *encoder_;
+    }
+
+private:
+    AsyncEncodeResult TakePackets(bool ok)
+    {
+        AsyncEncodeResult result{ok, std::move(packets_)};
+        packets_.clear();
+        return result;
+    }
+
+private:
+    std::shared_ptr<Encoder>   encoder_;
+    AsyncStrand                strand_;
+    std::vector<EncodedPacket> packets_; // 只在串行序列上访问
+};
+
+// 解码器的协程接口：数据经推送式 DecodeStream 解码，可传入任意长度的字节块；
+// 解码出的 PCM 通过解码器上安装的回调交付，回调在线程池线程上执行，co_await 返回时本块的回调均已完成
+template <typename Decoder>
+class AsyncDecoder
+{
+public:
+    AsyncDecoder(AsyncExecutor& executor, std::shared_ptr<Decoder> decoder)
+        : decoder_(std::move(decoder))
+        , strand_(executor)
+    {
+        if (!decoder_)
+        {
+            throw std::runtime_error("Decoder is null");
+        }
+    }
+
+    AsyncDecoder(const AsyncDecoder&)            = delete;
+    AsyncDecoder& operator=(const AsyncDecoder&) = delete;
+
+    AsyncOperation<bool> DecodeAsync(std::span<const uint8_t> data)
+    {
+        return AsyncOperation<bool>(strand_, [this, data]() { return decoder_->DecodeStream(data.data(), data.size()); });
+    }
+
+    AsyncOperation<bool> FlushAsync()
+    {
+        return AsyncOperation<bool>(strand_, [this]() { return decoder_->FlushStream(); });
+    }
+
+    Decoder& Codec()
+    {
+        return *decoder_;
+    }
+
+private:
+    std::shared_ptr<Decoder> decoder_;
+    AsyncStrand              strand_;
+};
+
+#endif // __ASYNC_CODEC_H__
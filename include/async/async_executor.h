@@ -0,0 +1,73 @@
+#ifndef __ASYNC_EXECUTOR_H__
+#define __ASYNC_EXECUTOR_H__
+
+#include <coroutine>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <work_stealing_pool.h>
+
+// 协程异步接口共用的执行器：编解码工作在固定大小的工作窃取线程池上执行，
+// 挂起的协程不占用线程，大量流可以共享少量线程
+class AsyncExecutor
+{
+private:
+    using TaskType                  = std::function<void()>;
+    using AsyncResumeDispatcherType = std::function<void(std::coroutine_handle<>)>;
+
+public:
+    explicit AsyncExecutor(int threads = 0); // threads <= 0 时使用全部硬件线程
+    ~AsyncExecutor();                        // 执行完已提交的工作后退出
+
+    AsyncExecutor(const AsyncExecutor&)            = delete;
+    AsyncExecutor& operator=(const AsyncExecutor&) = delete;
+
+    void Submit(TaskType task);
+    void Yield(TaskType task); // 排在线程已有的工作之后执行，用于分批执行后让出线程
+    // 默认在完成工作的线程池线程上直接恢复协程；事件循环程序可安装分发函数，把协程投递回事件循环线程恢复。
+    // 须在提交异步操作之前安装
+    bool InstallResumeDispatcher(AsyncResumeDispatcherType dispatcher);
+    void Resume(std::coroutine_handle<> handle);
+    int  ThreadCount() const;
+
+private:
+    AsyncResumeDispatcherType dispatcher_;
+    WorkStealingPool          pool_; // 最后声明，析构时最先等待剩余工作完成，此时分发函数仍然有效
+};
+
+// 每路流一个串行执行序列：投递的工作按顺序执行且同一时刻只在一个线程上运行，保证流内顺序，
+// 不同流的工作在线程池上并行。空闲的序列不占用线程，只保存一个空队列
+class AsyncStrand
+{
+private:
+    using TaskType = std::function<void()>;
+
+    struct State
+    {
+        std::mutex           mutex;
+        std::deque<TaskType> tasks;
+        bool                 scheduled; // 已提交到线程池或正在执行
+    };
+
+public:
+    explicit AsyncStrand(AsyncExecutor& executor);
+
+    AsyncStrand(const AsyncStrand&)            = delete;
+    AsyncStrand& operator=(const AsyncStrand&) = delete;
+
+    void           Post(TaskType task);
+    AsyncExecutor& Executor() const;
+
+private:
+    static void Run(AsyncExecutor* executor, std::shared_ptr<State> state);
+
+private:
+    static constexpr size_t kBatchTasks = 8U; // 每次调度最多执行的工作数，避免单路流长期占用线程
+
+    AsyncExecutor&         executor_;
+    std::shared_ptr<State> state_; // 线程池中的执行体共同持有
+};
+
+#endif // __ASYNC_EXECUTOR_H__
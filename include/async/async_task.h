@@ -0,0 +1,308 @@
+#ifndef __ASYNC_TASK_H__
+#define __ASYNC_TASK_H__
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+// 协程基础类型：Task 为惰性启动的单值协程，被 co_await 时才开始执行，结束后通过对称转移恢复等待方；
+// AsyncGenerator 为异步生成器，协程内可以 co_await 异步操作并 co_yield 多个值，由消费方逐个拉取。
+// 两者都只能移动，销毁时一并销毁协程帧。顶层 Task 通过 Spawn 分离执行或 SyncWait 阻塞等待
+
+template <typename T>
+class Task;
+
+namespace async_detail
+{
+// 协程结束时把执行权交还等待方，没有等待方(分离执行)时直接返回
+struct FinalAwaiter
+{
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+    {
+        std::coroutine_handle<> continuation = handle.promise().continuation_;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+
+    void await_resume() noexcept
+    {
+    }
+};
+
+struct TaskPromiseBase
+{
+    std::suspend_always initial_suspend() noexcept
+    {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() noexcept
+    {
+        return {};
+    }
+
+    void unhandled_exception() noexcept
+    {
+        exception_ = std::current_exception();
+    }
+
+    std::coroutine_handle<> continuation_;
+    std::exception_ptr      exception_;
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase
+{
+    Task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U&& value)
+    {
+        value_.emplace(std::forward<U>(value));
+    }
+
+    T Result()
+    {
+        if (exception_)
+        {
+            std::rethrow_exception(exception_);
+        }
+        return std::move(*value_);
+    }
+
+    std::optional<T> value_;
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase
+{
+    Task<void> get_return_object() noexcept;
+
+    void return_void() noexcept
+    {
+    }
+
+    void Result()
+    {
+        if (exception_)
+        {
+            std::rethrow_exception(exception_);
+        }
+    }
+};
+} // namespace async_detail
+
+template <typename T = void>
+class Task
+{
+public:
+    using promise_type = async_detail::TaskPromise<T>;
+
+    explicit Task(std::coroutine_handle<promise_type> handle)
+        : handle_(handle)
+    {
+    }
+
+    ~Task()
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    Task(Task&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr))
+    {
+    }
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle_)
+            {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task&)            = delete;
+    Task& operator=(const Task&) = delete;
+
+    bool await_ready() const noexcept
+    {
+        return !handle_ || handle_.done();
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+    {
+        handle_.promise().continuation_ = continuation;
+        return handle_;
+    }
+
+    T await_resume()
+    {
+        return handle_.promise().Result();
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace async_detail
+{
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept
+{
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept
+{
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+} // namespace async_detail
+
+template <typename T>
+class AsyncGenerator
+{
+public:
+    struct promise_type
+    {
+        AsyncGenerator get_return_object() noexcept
+        {
+            return AsyncGenerator(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        async_detail::FinalAwaiter final_suspend() noexcept
+        {
+            return {};
+        }
+
+        // 产出一个值后挂起，执行权交还消费方
+        async_detail::FinalAwaiter yield_value(T value)
+        {
+            value_.emplace(std::move(value));
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+            exception_ = std::current_exception();
+        }
+
+        std::coroutine_handle<> continuation_;
+        std::exception_ptr      exception_;
+        std::optional<T>        value_;
+    };
+
+    // co_await generator.Next() 恢复生成器直到产出下一个值，返回 false 表示已结束
+    class NextAwaiter
+    {
+    public:
+        explicit NextAwaiter(std::coroutine_handle<promise_type> handle)
+            : handle_(handle)
+        {
+        }
+
+        bool await_ready() const noexcept
+        {
+            return !handle_ || handle_.done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+        {
+            handle_.promise().continuation_ = continuation;
+            handle_.promise().value_.reset();
+            return handle_;
+        }
+
+        bool await_resume()
+        {
+            if (!handle_)
+            {
+                return false;
+            }
+            if (handle_.promise().exception_)
+            {
+                std::rethrow_exception(std::exchange(handle_.promise().exception_, nullptr));
+            }
+            return !handle_.done();
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    explicit AsyncGenerator(std::coroutine_handle<promise_type> handle)
+        : handle_(handle)
+    {
+    }
+
+    ~AsyncGenerator()
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    AsyncGenerator(AsyncGenerator&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr))
+    {
+    }
+
+    AsyncGenerator& operator=(AsyncGenerator&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle_)
+            {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    AsyncGenerator(const AsyncGenerator&)            = delete;
+    AsyncGenerator& operator=(const AsyncGenerator&) = delete;
+
+    NextAwaiter Next()
+    {
+        return NextAwaiter(handle_);
+    }
+
+    T& Value() // Next() 返回 true 后有效，可移动取走
+    {
+        return *handle_.promise().value_;
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// 分离执行 task，协程帧在结束时自行销毁；task 抛出的异常被忽略，需要时在协程内部捕获
+void Spawn(Task<void> task);
+// 在当前线程阻塞等待 task 结束，task 抛出的异常在此重新抛出；不可在线程池线程中调用
+void SyncWait(Task<void> task);
+
+#endif // __ASYNC_TASK_H__
@@ -0,0 +1,71 @@
+#ifndef __AUDIO_CODEC_FACTORY_H__
+#define __AUDIO_CODEC_FACTORY_H__
+
+#include <iostream>
+#include <memory>
+#include <tuple>
+
+#include <audio_format.h>
+#include <codec_pool.h>
+
+class AudioEncoderAAC;
+class AudioEncoderMP3;
+class AudioDecoderAAC;
+class AudioDecoderMP3;
+
+// 编解码器池的键：编码器使用 (codec, sample_rate, channels, bitrate)，
+// 解码器使用 (codec, sample_rate, channels) 与输出格式，bitrate 为 0
+struct AudioCodecKey
+{
+    AudioCodecType    codec;
+    int               sample_rate;
+    int               channels;
+    int64_t           bitrate;
+    AudioOutputFormat output_format;
+
+    bool operator<(const AudioCodecKey& other) const
+    {
+        return std::make_tuple(codec, sample_rate, channels, bitrate, output_format.layout,
+                               output_format.sample_rate, output_format.dither)
+               < std::make_tuple(other.codec, other.sample_rate, other.channels, other.bitrate,
+                                 other.output_format.layout, other.output_format.sample_rate,
+                                 other.output_format.dither);
+    }
+};
+
+// 预先打开编解码器实例的工厂，适用于大量短时流：
+// Acquire 返回的实例使用完毕释放后自动 Reset 并放回池中，下一个流直接复用，省去查找、分配与打开编解码器的开销。
+// 取出的实例需重新安装回调；统计开关保持上一次的设置。
+// 放回池中的实例默认保留 FIFO、帧、重采样器与转换缓冲区，复用时不再分配；
+// release_idle_buffers 为 true 时释放这些缓冲区，适合空闲实例多、复用不频繁的场景，复用后首次送入数据时重新分配。
+class AudioCodecFactory
+{
+public:
+    static constexpr size_t kDefaultMaxIdle = 16; // 每个键最多保留的空闲实例数
+
+    explicit AudioCodecFactory(size_t max_idle_per_key = kDefaultMaxIdle, bool release_idle_buffers = false);
+    ~AudioCodecFactory();
+
+    AudioCodecFactory(const AudioCodecFactory&)            = delete;
+    AudioCodecFactory& operator=(const AudioCodecFactory&) = delete;
+
+    // 创建失败时返回空指针
+    std::shared_ptr<AudioEncoderAAC> AcquireAACEncoder(int64_t bitrate, int sample_rate, int channels);
+    std::shared_ptr<AudioEncoderMP3> AcquireMP3Encoder(int64_t bitrate, int sample_rate, int channels);
+    std::shared_ptr<AudioDecoderAAC> AcquireAACDecoder(int sample_rate = 0, int channels = 0,
+                                                       const AudioOutputFormat& output_format = AudioOutputFormat());
+    std::shared_ptr<AudioDecoderMP3> AcquireMP3Decoder(const AudioOutputFormat& output_format = AudioOutputFormat());
+
+    // 预先打开 count 个编码器/解码器实例，返回该键下的空闲实例数
+    size_t PrewarmEncoders(AudioCodecType codec, int64_t bitrate, int sample_rate, int channels, size_t count);
+    size_t PrewarmDecoders(AudioCodecType codec, int sample_rate, int channels, size_t count,
+                           const AudioOutputFormat& output_format = AudioOutputFormat());
+
+private:
+    CodecPool<AudioEncoderAAC, AudioCodecKey> aac_encoders_;
+    CodecPool<AudioEncoderMP3, AudioCodecKey> mp3_encoders_;
+    CodecPool<AudioDecoderAAC, AudioCodecKey> aac_decoders_;
+    CodecPool<AudioDecoderMP3, AudioCodecKey> mp3_decoders_;
+};
+
+#endif // __AUDIO_CODEC_FACTORY_H__
@@ -0,0 +1,67 @@
+#ifndef __AUDIO_FORMAT_H__
+#define __AUDIO_FORMAT_H__
+
+#include <cstdint>
+#include <cstddef>
+
+// 工程内支持的压缩音频格式
+enum class AudioCodecType
+{
+    kAAC,
+    kMP3
+};
+
+// 解码器输出的样本排列与格式
+enum class AudioSampleLayout
+{
+    kInterleavedFloat, // 交错 32 位浮点(FLT)
+    kPlanarFloat,      // 平面 32 位浮点(FLTP)，与解码器原生格式一致时零拷贝
+    kInterleavedS16    // 交错 16 位整数(S16)
+};
+
+// 解码器输出格式，构造解码器时指定
+struct AudioOutputFormat
+{
+    AudioSampleLayout layout      = AudioSampleLayout::kInterleavedFloat;
+    int               sample_rate = 0;    // 0 表示保持码流的采样率，否则经 swresample 重采样
+    bool              dither      = true; // 输出 S16 时是否加 TPDF 抖动
+};
+
+// 编码器输入的 PCM 样本格式
+enum class AudioInputSampleFormat
+{
+    kS16,        // 交错 16 位整数
+    kS24In32,    // 交错 24 位整数，存放在 32 位容器的低 24 位
+    kFloat,      // 交错 32 位浮点
+    kPlanarFloat // 平面 32 位浮点，Encode 的数据按声道依次连续存放
+};
+
+// 重采样的质量/速度档位，只在输入采样率与编码器不同时生效
+enum class AudioResampleQuality
+{
+    kFast,     // 短滤波器加线性插值，耗时约为默认的 1/3
+    kBalanced, // swresample 默认参数
+    kHigh      // 长滤波器，阻带抑制更好，耗时约为默认的 2 倍
+};
+
+// 编码器输入格式，构造编码器时指定；声道数与编码器相同
+struct AudioInputFormat
+{
+    AudioInputSampleFormat format      = AudioInputSampleFormat::kFloat;
+    int                    sample_rate = 0; // 0 表示与编码器采样率相同
+    AudioResampleQuality   quality     = AudioResampleQuality::kBalanced;
+};
+
+// 一帧解码输出的视图，指针在回调返回后失效
+struct AudioFrameView
+{
+    const uint8_t* const* data;        // 交错格式只有 data[0]，平面格式每个声道一个平面
+    int                   planes;      // 数据平面数
+    int                   channels;
+    int                   nb_samples;  // 每个声道的样本数
+    int                   sample_rate;
+    AudioSampleLayout     layout;
+    size_t                plane_size;  // 每个平面的字节数
+};
+
+#endif // __AUDIO_FORMAT_H__
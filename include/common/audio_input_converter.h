@@ -0,0 +1,68 @@
+#ifndef __AUDIO_INPUT_CONVERTER_H__
+#define __AUDIO_INPUT_CONVERTER_H__
+
+#include <iostream>
+#include <vector>
+
+extern "C"
+{
+#include <libavutil/audio_fifo.h>
+#include <libswresample/swresample.h>
+}
+
+#include <audio_format.h>
+#include <sample_convert.h>
+
+// 将编码器输入的 PCM 转换为编码器原生的平面格式(FLTP 或 S16P)并写入 FIFO。
+// 采样率相同时由 SIMD 内核一次完成解交错与格式转换，原生格式直接写入 FIFO；
+// 采样率不同时先转换为平面浮点，再由 swresample 按所选档位重采样。
+// 重采样器与转换缓冲区在首次写入时才创建，Reset 后保留供下一路流复用，ReleaseBuffers 时释放
+class AudioInputConverter
+{
+public:
+    static constexpr int kChunkSamples = 4096; // 单次转换的最大样本数，转换缓冲区按此分配
+
+    // target 只支持 AV_SAMPLE_FMT_FLTP 与 AV_SAMPLE_FMT_S16P，失败时抛出 std::runtime_error
+    AudioInputConverter(const AudioInputFormat& format, int channels, int sample_rate, AVSampleFormat target);
+    ~AudioInputConverter();
+
+    AudioInputConverter(const AudioInputConverter&)            = delete;
+    AudioInputConverter& operator=(const AudioInputConverter&) = delete;
+
+    int SampleCount(size_t size) const; // size 字节的输入包含的完整样本帧数
+    // 交错输入：先用 data 开头的字节补全上次留下的不足一个样本帧的数据并写入 fifo，data/size 前移越过已用的字节；
+    // 平面输入各声道连续存放，size 须为完整样本帧的整数倍，否则返回 false
+    bool WriteCarry(const uint8_t*& data, size_t& size, AVAudioFifo* fifo);
+    void SaveCarry(const uint8_t* data, size_t size); // 保存 size 字节输入末尾不足一个样本帧的字节，留待下次补全
+    // 转换 data 中从 offset 开始的 samples(不超过 kChunkSamples)个样本帧并写入 fifo；
+    // total_samples 为 data 的总样本帧数，平面输入据此定位各声道
+    bool Write(const uint8_t* data, int total_samples, int offset, int samples, AVAudioFifo* fifo);
+    bool Flush(AVAudioFifo* fifo); // 排空重采样器延迟中的样本，采样率相同时无操作；不足一个样本帧的剩余字节被丢弃
+    bool Reset();                  // 丢弃重采样器中缓存的样本与剩余字节，保留已分配的缓冲区
+    void ReleaseBuffers();         // 释放重采样器与转换缓冲区，下次写入时重新创建
+    size_t MemoryUsage() const;    // 当前持有的转换缓冲区字节数
+
+private:
+    bool ConvertToTarget(const uint8_t* const* input, int samples);
+    bool ConvertToFloat(const uint8_t* const* input, int samples);
+    bool ConfigureResampler();
+    bool Allocate();
+    void Release();
+
+private:
+    AudioInputFormat            format_;
+    int                         channels_;
+    int                         sample_rate_;
+    AVSampleFormat              target_;
+    int                         bytes_per_sample_;
+    bool                        native_;          // 输入即为目标格式，直接写入 FIFO
+    bool                        allocated_;
+    SwrContext*                 swr_ctx_;         // 仅在采样率不同时创建
+    std::vector<const uint8_t*> input_planes_;
+    std::vector<uint8_t*>       stage_planes_;    // 重采样前的平面浮点缓冲区
+    std::vector<uint8_t*>       output_planes_;   // 目标格式的平面缓冲区
+    int                         output_samples_;  // 目标缓冲区可容纳的样本数
+    std::vector<uint8_t>        carry_;           // 上次交错输入末尾不足一个样本帧的字节
+};
+
+#endif // __AUDIO_INPUT_CONVERTER_H__
@@ -0,0 +1,65 @@
+#ifndef __AUDIO_OUTPUT_CONVERTER_H__
+#define __AUDIO_OUTPUT_CONVERTER_H__
+
+#include <iostream>
+#include <vector>
+#include <memory>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libswresample/swresample.h>
+}
+
+#include <audio_format.h>
+#include <sample_convert.h>
+#include <loudness_meter.h>
+
+// 将解码器输出的 AVFrame 转换为调用方要求的输出格式。
+// 采样率一致且解码器输出为平面浮点时走 SIMD 内核(平面输出直接引用帧数据，不做拷贝)，
+// 其余情况(重采样、其他原生格式)才使用 swresample，且在码流参数变化时自动重新配置；
+// 重新配置会丢弃旧重采样器中的延迟样本，需要完整输出时先用 ResamplerChanges 判断并调用 Flush 取出。
+// 开启响度测量时，解码帧在转换前趁数据仍在缓存中由响度计读取一遍，不再需要对输出 PCM 单独分析
+class AudioOutputConverter
+{
+public:
+    explicit AudioOutputConverter(const AudioOutputFormat& format);
+    ~AudioOutputConverter();
+
+    AudioOutputConverter(const AudioOutputConverter&)            = delete;
+    AudioOutputConverter& operator=(const AudioOutputConverter&) = delete;
+
+    bool                 Convert(const AVFrame* frame, AudioFrameView& view);
+    // 取出重采样器中的延迟样本(码流结束或重采样器重建前调用)，没有重采样器或已取空时 view.nb_samples 为 0
+    bool                 Flush(AudioFrameView& view);
+    bool                 ResamplerChanges(const AVFrame* frame) const; // Convert 该帧时会重建已有的重采样器
+    bool                 Reset(); // 丢弃重采样器中缓存的样本并清空响度测量结果，保留已分配的缓冲区
+    void                 ReleaseBuffers(); // 释放重采样器与输出缓冲区，下一帧按需重新创建
+    size_t               MemoryUsage() const; // 当前持有的输出缓冲区与响度计字节数
+    // 开启时创建响度计，关闭时释放；native_format 为解码器的原生格式，只支持平面浮点与平面 16 位整数，其他格式返回 false
+    bool                 EnableLoudness(bool enable, AVSampleFormat native_format);
+    void                 Measure(const AVFrame* frame); // 只测量响度不转换格式，用于没有输出回调的解码；Convert 内部已调用
+    const LoudnessMeter* Loudness() const;            // 未开启时返回空指针
+
+private:
+    bool           ConvertWithResampler(const AVFrame* frame, AudioFrameView& view);
+    void           PrepareResamplerOutput(int out_samples, int channels);
+    bool           ConfigureResampler(const AVFrame* frame);
+    uint8_t*       Reserve(size_t size);
+    AVSampleFormat TargetSampleFormat() const;
+
+private:
+    AudioOutputFormat              format_;
+    SwrContext*                    swr_ctx_; // 仅在需要重采样或格式不受内核支持时创建
+    int                            swr_in_rate_;
+    int                            swr_in_channels_;
+    AVSampleFormat                 swr_in_format_;
+    std::vector<uint8_t>           buffer_;  // 输出缓冲区，首帧时分配，ReleaseBuffers 前只增不减并在帧间复用
+    std::vector<uint8_t*>          planes_;
+    DitherState                    dither_;
+    std::unique_ptr<LoudnessMeter> meter_;   // 未开启响度测量时为空
+    std::vector<float>             meter_samples_; // 平面 16 位整数帧转换为浮点后供响度计读取
+    std::vector<const float*>      meter_planes_;
+};
+
+#endif // __AUDIO_OUTPUT_CONVERTER_H__
@@ -0,0 +1,75 @@
+#ifndef __BUFFER_POOL_H__
+#define __BUFFER_POOL_H__
+
+#include <iostream>
+#include <memory>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavutil/buffer.h>
+#include <libavutil/frame.h>
+}
+
+// 进程内共享的 AVBufferPool：按容量分级(2 的幂，不小于 kMinPoolSize)保存，
+// 参数相同的实例请求的容量相同，因而取到同一个池，缓冲区在实例之间循环使用。
+// 最后一个使用者释放后池被注销，尚未归还的缓冲区在归还时释放
+class SharedBufferPool
+{
+public:
+    static constexpr size_t kMinPoolSize = 256U;
+
+    // 返回容量不小于 size 的池，失败时返回空指针；线程安全
+    static std::shared_ptr<AVBufferPool> Acquire(size_t size);
+    static size_t                        PoolSize(size_t size); // size 所属的容量等级
+};
+
+// 数据包缓冲区池：编码器通过 get_encode_buffer 从池中取输出包的缓冲区，
+// 解码器把输入数据拷贝进池化的引用计数缓冲区(否则 avcodec_send_packet 会为每个包新分配一块并拷贝)
+class PacketBufferPool
+{
+public:
+    PacketBufferPool();
+    ~PacketBufferPool();
+
+    PacketBufferPool(const PacketBufferPool&)            = delete;
+    PacketBufferPool& operator=(const PacketBufferPool&) = delete;
+
+    // 须在 avcodec_open2 之前调用；编码器不支持 AV_CODEC_CAP_DR1 或 libavcodec 过旧时返回 false，
+    // 此时仍由 libavcodec 分配输出缓冲区
+    bool InstallEncodeBuffer(AVCodecContext* codec_context);
+    // 将 data 拷贝到池化缓冲区并设置 packet 的 buf/data/size，尾部填充字节清零
+    bool Fill(AVPacket* packet, const uint8_t* data, size_t size);
+
+private:
+    AVBufferRef* Get(size_t size); // size 不含填充
+    static int   GetEncodeBuffer(AVCodecContext* codec_context, AVPacket* packet, int flags);
+
+private:
+    std::shared_ptr<AVBufferPool> pool_;
+    size_t                        pool_size_;
+};
+
+// 音频帧缓冲区池：每个平面一块池化缓冲区，格式、声道数与帧长相同的实例共享同一个池
+class AudioFramePool
+{
+public:
+    AudioFramePool(AVSampleFormat format, int channels, int nb_samples);
+    ~AudioFramePool();
+
+    AudioFramePool(const AudioFramePool&)            = delete;
+    AudioFramePool& operator=(const AudioFramePool&) = delete;
+
+    // 帧缓冲区可写时直接返回；否则(首次使用或编码器仍持有上一帧的引用)换上池中的缓冲区，
+    // 帧的其他字段保持不变，新缓冲区的内容未定义
+    bool GetBuffer(AVFrame* frame);
+    void   ReleaseBuffer(AVFrame* frame) const;    // 缓冲区归还池中，帧的其他字段保持不变
+    size_t BufferSize(const AVFrame* frame) const; // 帧当前持有的缓冲区字节数，未持有时为 0
+
+private:
+    std::shared_ptr<AVBufferPool> pool_;
+    int                           planes_;
+    int                           linesize_;
+};
+
+#endif // __BUFFER_POOL_H__
@@ -0,0 +1,12 @@
+#ifndef __CODEC_LOG_H__
+#define __CODEC_LOG_H__
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+}
+
+// 编解码器支持的采样格式只在 FFmpeg 日志级别不低于 verbose 时输出，默认静默；name 为日志前缀(如 "AAC")
+void LogSupportedSampleFormats(const AVCodec* codec, const char* name);
+
+#endif // __CODEC_LOG_H__
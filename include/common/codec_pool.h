@@ -0,0 +1,155 @@
+#ifndef __CODEC_POOL_H__
+#define __CODEC_POOL_H__
+
+#include <iostream>
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <functional>
+
+// 已打开的编解码器实例池：按 Key 保存空闲实例，Acquire 优先复用空闲实例，没有时通过工厂函数创建。
+// 返回的 shared_ptr 释放时实例经 Reset() 与 ClearCallbacks() 后放回池中，Reset 失败或池已满则直接销毁；
+// 池先于实例销毁时，实例释放后直接销毁。Reset 保留实例已分配的缓冲区，复用时不再分配；
+// release_idle_buffers 为 true 时放回池中前再调用 ReleaseBuffers()，空闲实例不占用缓冲区，代价是复用后首次送入数据时重新分配。
+// Codec 需提供 bool Reset()、void ClearCallbacks() 与 void ReleaseBuffers()。
+template <typename Codec, typename Key>
+class CodecPool
+{
+private:
+    using FactoryType = std::function<std::unique_ptr<Codec>(const Key&)>;
+
+    struct State
+    {
+        std::mutex                                         mutex;
+        std::map<Key, std::vector<std::unique_ptr<Codec>>> idle;
+        size_t                                             max_idle;     // 每个 Key 最多保留的空闲实例数
+        bool                                               release_idle; // 放回池中前释放实例的缓冲区
+        FactoryType                                        factory;
+    };
+
+public:
+    CodecPool(FactoryType factory, size_t max_idle_per_key, bool release_idle_buffers = false)
+        : state_(std::make_shared<State>())
+    {
+        state_->max_idle     = max_idle_per_key;
+        state_->release_idle = release_idle_buffers;
+        state_->factory      = factory;
+    }
+
+    CodecPool(const CodecPool&)            = delete;
+    CodecPool& operator=(const CodecPool&) = delete;
+
+    // 创建失败时返回空指针
+    std::shared_ptr<Codec> Acquire(const Key& key)
+    {
+        std::unique_ptr<Codec> codec;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            auto                        it = state_->idle.find(key);
+            if (it != state_->idle.end() && !it->second.empty())
+            {
+                codec = std::move(it->second.back());
+                it->second.pop_back();
+            }
+        }
+
+        if (!codec)
+        {
+            codec = Create(key);
+            if (!codec)
+            {
+                return nullptr;
+            }
+        }
+
+        std::weak_ptr<State> weak_state = state_;
+        return std::shared_ptr<Codec>(codec.release(), [weak_state, key](Codec* released) {
+            Release(weak_state, key, released);
+        });
+    }
+
+    // 预先创建实例，使该 Key 的空闲实例数达到 count(不超过上限)，返回实际的空闲实例数
+    size_t Prewarm(const Key& key, size_t count)
+    {
+        for (;;)
+        {
+            {
+                std::lock_guard<std::mutex> lock(state_->mutex);
+                size_t                      idle = state_->idle[key].size();
+                if (idle >= count || idle >= state_->max_idle)
+                {
+                    return idle;
+                }
+            }
+
+            // 打开编解码器较慢，不在锁内进行
+            std::unique_ptr<Codec> codec = Create(key);
+            if (!codec)
+            {
+                return IdleCount(key);
+            }
+
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->idle[key].push_back(std::move(codec));
+        }
+    }
+
+    size_t IdleCount(const Key& key) const
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        auto                        it = state_->idle.find(key);
+
+        return it != state_->idle.end() ? it->second.size() : 0;
+    }
+
+    void Clear()
+    {
+        std::map<Key, std::vector<std::unique_ptr<Codec>>> idle;
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            idle.swap(state_->idle);
+        }
+    }
+
+private:
+    std::unique_ptr<Codec> Create(const Key& key)
+    {
+        try
+        {
+            return state_->factory(key);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Could not create pooled codec: " << e.what() << std::endl;
+            return nullptr;
+        }
+    }
+
+    static void Release(const std::weak_ptr<State>& weak_state, const Key& key, Codec* released)
+    {
+        std::unique_ptr<Codec> codec(released);
+        std::shared_ptr<State> state = weak_state.lock();
+        if (!state || !codec->Reset())
+        {
+            return;
+        }
+        codec->ClearCallbacks();
+        if (state->release_idle)
+        {
+            codec->ReleaseBuffers();
+        }
+
+        std::lock_guard<std::mutex>          lock(state->mutex);
+        std::vector<std::unique_ptr<Codec>>& idle = state->idle[key];
+        if (idle.size() < state->max_idle)
+        {
+            idle.push_back(std::move(codec));
+        }
+    }
+
+private:
+    std::shared_ptr<State> state_;
+};
+
+#endif // __CODEC_POOL_H__
@@ -0,0 +1,209 @@
+#ifndef __CODEC_STATS_H__
+#define __CODEC_STATS_H__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// 编解码器运行统计：输入输出帧数/字节数、错误数，以及各处理阶段耗时的 log2 直方图。
+// 统计对象只在调用 EnableStats 后创建，未启用时各统计点只是一次空指针判断；
+// 启用后计时使用 TSC(非 x86 平台为 steady_clock)，计数由编解码线程单线程写入，无锁无原子读改写。
+enum class CodecStage
+{
+    kConvert,  // 采样格式转换(编码器的 swr_convert，解码器的输出格式转换)
+    kSend,     // avcodec_send_frame / avcodec_send_packet
+    kReceive,  // avcodec_receive_packet / avcodec_receive_frame
+    kCallback, // 用户回调
+    kCount,
+};
+
+constexpr int kCodecStageCount   = static_cast<int>(CodecStage::kCount);
+constexpr int kCodecStatsBuckets = 48; // 第 i 个桶统计耗时在 [2^i, 2^(i+1)) 个计时单位内的次数
+
+const char* CodecStageName(CodecStage stage);
+
+struct CodecStageSnapshot
+{
+    uint64_t count;
+    uint64_t total_ticks;
+    uint64_t max_ticks;
+    uint64_t buckets[kCodecStatsBuckets];
+};
+
+struct CodecStatsSnapshot
+{
+    uint64_t           frames_in;  // 编码器：送入编码器的帧数；解码器：送入的数据包数
+    uint64_t           frames_out; // 编码器：输出的数据包数；解码器：输出的帧数
+    uint64_t           bytes_in;   // 编码器：送入帧的PCM字节数(编码器原生格式)；解码器：数据包字节数
+    uint64_t           bytes_out;  // 编码器：数据包字节数(不含 ADTS 头)；解码器：转换后输出的PCM字节数
+    uint64_t           errors;
+    double             ns_per_tick; // 计时单位换算为纳秒的系数
+    CodecStageSnapshot stages[kCodecStageCount];
+
+    double TotalNanoseconds(CodecStage stage) const;
+    double MeanNanoseconds(CodecStage stage) const;
+    double MaxNanoseconds(CodecStage stage) const;
+    double PercentileNanoseconds(CodecStage stage, double ratio) const; // 精度为直方图桶宽
+};
+
+// 单个编解码器实例持有的内存(字节)。buffers 中的缓冲区都在首次送入数据时才分配，Reset 后保留，ReleaseBuffers 后释放，
+// 打开后未使用或已释放缓冲区的空闲实例为 0。FFmpeg 编解码器上下文及其私有状态的大小不对外公开，不计入此处，
+// 空闲实例的实际堆占用(含这部分)由基准程序的 --idle-streams 测量
+struct CodecMemoryUsage
+{
+    size_t instance; // 实例对象本身及其持有的统计、静音检测、响度计等辅助对象
+    size_t buffers;  // FIFO、输入帧、格式转换、输出与待交付数据包等缓冲区
+
+    size_t Total() const
+    {
+        return instance + buffers;
+    }
+};
+
+class CodecStats
+{
+private:
+    struct StageHistogram
+    {
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> total_ticks;
+        std::atomic<uint64_t> max_ticks;
+        std::atomic<uint64_t> buckets[kCodecStatsBuckets];
+    };
+
+public:
+    CodecStats();
+
+    CodecStats(const CodecStats&)            = delete;
+    CodecStats& operator=(const CodecStats&) = delete;
+
+    static uint64_t ReadTicks()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+#endif
+    }
+
+    void AddFramesIn(uint64_t frames, uint64_t bytes)
+    {
+        Add(frames_in_, frames);
+        Add(bytes_in_, bytes);
+    }
+
+    void AddFramesOut(uint64_t frames, uint64_t bytes)
+    {
+        Add(frames_out_, frames);
+        Add(bytes_out_, bytes);
+    }
+
+    void AddError()
+    {
+        Add(errors_, 1);
+    }
+
+    void RecordStage(CodecStage stage, uint64_t ticks)
+    {
+        StageHistogram& histogram = stages_[static_cast<int>(stage)];
+        int             bucket    = ticks > 1 ? 63 - __builtin_clzll(ticks) : 0;
+
+        Add(histogram.count, 1);
+        Add(histogram.total_ticks, ticks);
+        Add(histogram.buckets[bucket < kCodecStatsBuckets ? bucket : kCodecStatsBuckets - 1], 1);
+        if (ticks > histogram.max_ticks.load(std::memory_order_relaxed))
+        {
+            histogram.max_ticks.store(ticks, std::memory_order_relaxed);
+        }
+    }
+
+    void Snapshot(CodecStatsSnapshot& snapshot) const; // 可在其他线程调用
+    void Reset();                                      // 与编解码线程并发调用时可能漏掉正在写入的少量计数
+
+private:
+    // 只有编解码线程写入，普通的读写即可，原子类型仅用于保证其他线程读取快照时无数据竞争
+    static void Add(std::atomic<uint64_t>& counter, uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> frames_in_;
+    std::atomic<uint64_t> frames_out_;
+    std::atomic<uint64_t> bytes_in_;
+    std::atomic<uint64_t> bytes_out_;
+    std::atomic<uint64_t> errors_;
+    StageHistogram        stages_[kCodecStageCount];
+};
+
+// 作用域计时：stats 为空(统计未启用)时不读取时钟
+class CodecStageTimer
+{
+public:
+    CodecStageTimer(CodecStats* stats, CodecStage stage)
+        : stats_(stats)
+        , stage_(stage)
+        , start_(stats ? CodecStats::ReadTicks() : 0)
+    {
+    }
+
+    ~CodecStageTimer()
+    {
+        if (stats_)
+        {
+            stats_->RecordStage(stage_, CodecStats::ReadTicks() - start_);
+        }
+    }
+
+    CodecStageTimer(const CodecStageTimer&)            = delete;
+    CodecStageTimer& operator=(const CodecStageTimer&) = delete;
+
+private:
+    CodecStats* stats_;
+    CodecStage  stage_;
+    uint64_t    start_;
+};
+
+// 编解码器持有的可选统计对象，四种编解码器的 EnableStats/GetStats/ResetStats 均转发到这里。
+// 未开启时为空，各统计点以 if (stats_) 判断，计时器通过 Get() 取得指针(为空时不计时)
+class CodecStatsHolder
+{
+public:
+    CodecStatsHolder() = default;
+
+    CodecStatsHolder(const CodecStatsHolder&)            = delete;
+    CodecStatsHolder& operator=(const CodecStatsHolder&) = delete;
+
+    void Enable(bool enable);                          // 开启时创建统计对象，关闭时释放；不可与编解码并发调用
+    bool Snapshot(CodecStatsSnapshot& snapshot) const; // 未开启统计时返回 false，可在其他线程调用
+    void Reset();
+    void RecordError();
+
+    CodecStats* Get() const
+    {
+        return stats_.get();
+    }
+
+    CodecStats* operator->() const
+    {
+        return stats_.get();
+    }
+
+    explicit operator bool() const
+    {
+        return static_cast<bool>(stats_);
+    }
+
+private:
+    std::unique_ptr<CodecStats> stats_; // 未开启统计时为空
+};
+
+#endif // __CODEC_STATS_H__
@@ -0,0 +1,56 @@
+#ifndef __ENCODED_PACKET_H__
+#define __ENCODED_PACKET_H__
+
+#include <iostream>
+
+#include <sys/uio.h>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+}
+
+// 编码输出的数据包：直接接管 AVPacket 的引用计数缓冲区(不另外分配 AVPacket)，只能移动不能拷贝，
+// 调用方可以在回调返回后继续持有数据而无需拷贝；Ref() 生成共享同一缓冲区的新引用。
+// 缓冲区来自编码器的包缓冲区池时，最后一个引用释放后缓冲区回到池中。
+// AAC 数据包同时携带对应的 ADTS 头，可通过 FillIovec 直接组成 writev/sendmsg 的分散写入
+class EncodedPacket
+{
+public:
+    static constexpr size_t kMaxHeaderSize = 9U;
+
+    EncodedPacket();
+    explicit EncodedPacket(AVPacket* packet); // 接管 packet 的数据引用，packet 被置为空包
+    ~EncodedPacket();
+
+    EncodedPacket(EncodedPacket&& other) noexcept;
+    EncodedPacket& operator=(EncodedPacket&& other) noexcept;
+    EncodedPacket(const EncodedPacket&)            = delete;
+    EncodedPacket& operator=(const EncodedPacket&) = delete;
+
+    EncodedPacket  Ref() const;
+    bool           Empty() const;
+    const uint8_t* Data() const;
+    size_t         Size() const;
+    int64_t        Pts() const;
+    int64_t        Duration() const;
+    const uint8_t* Header() const;
+    size_t         HeaderSize() const;
+    void           SetHeader(const uint8_t* header, size_t size);
+    int            FillIovec(struct iovec* iov) const; // 写入头部与负载共最多 2 个 iovec，返回个数
+    AVBufferRef*   Buffer() const;
+
+private:
+    void Release();
+
+private:
+    AVBufferRef*   buf_;
+    const uint8_t* data_;
+    size_t         size_;
+    int64_t        pts_;
+    int64_t        duration_;
+    uint8_t        header_[kMaxHeaderSize];
+    uint8_t        header_size_;
+};
+
+#endif // __ENCODED_PACKET_H__
@@ -0,0 +1,103 @@
+#ifndef __LOUDNESS_METER_H__
+#define __LOUDNESS_METER_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <array>
+
+// 响度与峰值的测量结果。响度单位为 LUFS，数据不足一个测量窗口时为负无穷；
+// 峰值为线性满幅度(1.0 对应 0 dBFS)，取所有声道的最大值，20*log10 得到 dBFS/dBTP
+struct LoudnessSnapshot
+{
+    // 截至最近一帧的测量值
+    double momentary;         // 400ms 窗口
+    double short_term;        // 3s 窗口
+    double frame_sample_peak; // 最近一帧的样本峰值
+    double frame_true_peak;   // 最近一帧的真峰值
+    // 整个码流
+    double   integrated;      // 经 -70 LUFS 绝对门限与 -10 LU 相对门限后的综合响度
+    double   max_momentary;
+    double   max_short_term;
+    double   sample_peak;
+    double   true_peak;
+    uint64_t samples;         // 已测量的每声道样本数
+};
+
+// EBU R128 / ITU-R BS.1770-4 响度计：K 加权滤波后按 100ms 子块累计能量，
+// 瞬时/短期响度取最近 4/30 个子块，综合响度由 400ms(75% 重叠)门限块计算。
+// 门限块能量记入 0.1 LU 宽的直方图，内存占用固定，门限精度为 ±0.05 LU。
+// 真峰值对每个声道做 4 倍过采样(48 抽头、每相 12 抽头的多相插值滤波器)后取最大绝对值。
+// 采样率或声道数变化时视为新的码流，全部结果重新开始
+class LoudnessMeter
+{
+private:
+    static constexpr int kTruePeakFactor  = 4;
+    static constexpr int kTruePeakTaps    = 12; // 每相抽头数
+    static constexpr int kHistogramBins   = 1000;
+    static constexpr int kShortTermBlocks = 30; // 短期响度窗口的子块数
+
+    struct Biquad
+    {
+        double b0;
+        double b1;
+        double b2;
+        double a1;
+        double a2;
+    };
+
+    struct ChannelState
+    {
+        double z[2][2];                    // 两级滤波器的延迟状态
+        double energy;                     // 当前子块内 K 加权样本的平方和
+        double weight;                     // 声道权重，LFE 为 0，环绕声道为 1.41
+        float  history[kTruePeakTaps - 1]; // 真峰值插值所需的前几个样本
+    };
+
+    struct HistogramBin
+    {
+        uint64_t count;
+        double   energy;
+    };
+
+public:
+    LoudnessMeter();
+
+    // 测量一帧平面浮点样本，planes 为各声道平面指针
+    void Process(const float* const* planes, int channels, int nb_samples, int sample_rate);
+    void Reset(); // 清空全部结果，开始测量新的码流
+    void Snapshot(LoudnessSnapshot& snapshot) const;
+    size_t MemoryUsage() const; // 对象本身与声道状态、直方图等缓冲区的字节数
+
+private:
+    void   Configure(int channels, int sample_rate);
+    void   FilterChannel(ChannelState& state, const float* src, int nb_samples, float& peak);
+    float  TruePeak(ChannelState& state, const float* src, int nb_samples);
+    void   FinishBlock();
+    double WindowEnergy(int blocks) const; // 最近 blocks 个子块的平均能量
+
+private:
+    int                                    channels_;
+    int                                    sample_rate_;
+    int                                    block_samples_;  // 每个 100ms 子块的样本数
+    int                                    block_filled_;
+    Biquad                                 shelf_;          // 第一级：高频搁架
+    Biquad                                 highpass_;       // 第二级：RLB 高通
+    std::vector<ChannelState>              states_;
+    std::array<double, kShortTermBlocks>   blocks_;         // 最近子块能量的环形缓冲区
+    uint64_t                               block_count_;    // 已完成的子块数
+    std::vector<HistogramBin>              histogram_;
+    std::vector<float>                     scratch_;        // 真峰值插值的输入缓冲区，只增不减
+    float                                  coefficients_[kTruePeakFactor][kTruePeakTaps];
+    double                                 momentary_;
+    double                                 short_term_;
+    double                                 max_momentary_;
+    double                                 max_short_term_;
+    float                                  frame_sample_peak_;
+    float                                  frame_true_peak_;
+    float                                  sample_peak_;
+    float                                  true_peak_;
+    uint64_t                               samples_;
+};
+
+#endif // __LOUDNESS_METER_H__
@@ -0,0 +1,44 @@
+#ifndef __SAMPLE_CONVERT_H__
+#define __SAMPLE_CONVERT_H__
+
+#include <cstdint>
+#include <cstddef>
+
+// 采样格式转换内核：运行时根据CPU特性选择 AVX2 / SSE2 / 标量实现
+
+// 平面浮点(FLTP) -> 交错浮点(FLT)，src为各声道平面指针，dst容纳 channels * nb_samples 个float
+void InterleaveFloat(const float* const* src, float* dst, int channels, int nb_samples);
+
+// TPDF 抖动使用的随机数状态(4路 xorshift32，标量实现只使用第一路)
+struct DitherState
+{
+    uint32_t state[4];
+};
+
+void InitDitherState(DitherState& dither, uint32_t seed);
+
+// 平面浮点(FLTP) -> 交错 16 位整数(S16)，超出[-1, 1)的样本饱和截断，dither 为空时不加抖动
+void InterleaveFloatToS16(const float* const* src, int16_t* dst, int channels, int nb_samples, DitherState* dither);
+
+// 交错 PCM -> 平面浮点(FLTP)，dst 为各声道平面指针，每个平面容纳 nb_samples 个样本。
+// 24 位样本存放在 32 位容器的低 24 位，高 8 位被忽略
+void DeinterleaveS16ToFloat(const int16_t* src, float* const* dst, int channels, int nb_samples);
+void DeinterleaveS24ToFloat(const int32_t* src, float* const* dst, int channels, int nb_samples);
+void DeinterleaveFloat(const float* src, float* const* dst, int channels, int nb_samples);
+
+// 交错 PCM -> 平面 16 位整数(S16P)，24 位输入四舍五入，浮点输入超出[-1, 1)时饱和截断，均不加抖动
+void DeinterleaveS16(const int16_t* src, int16_t* const* dst, int channels, int nb_samples);
+void DeinterleaveS24ToS16(const int32_t* src, int16_t* const* dst, int channels, int nb_samples);
+void DeinterleaveFloatToS16(const float* src, int16_t* const* dst, int channels, int nb_samples);
+
+// 单个平面的浮点 -> 16 位整数，规则同上
+void ConvertFloatToS16(const float* src, int16_t* dst, int nb_samples);
+
+// 单个平面的样本平方和，用于静音/低能量检测；浮点样本以 1.0 为满幅度，16 位整数按原始值累加
+double SumSquaresFloat(const float* src, int nb_samples);
+double SumSquaresS16(const int16_t* src, int nb_samples);
+
+// 返回当前使用的内核名称，便于日志与基准测试
+const char* SampleConvertKernelName();
+
+#endif // __SAMPLE_CONVERT_H__
@@ -0,0 +1,49 @@
+#ifndef __SILENCE_DETECTOR_H__
+#define __SILENCE_DETECTOR_H__
+
+#include <iostream>
+#include <vector>
+
+extern "C"
+{
+#include <libavutil/samplefmt.h>
+}
+
+// 编码器对静音帧的处理方式
+enum class SilenceMode
+{
+    kOff,         // 不检测，全部帧送入编码器
+    kCachedFrame, // 以预先编码好的静音帧代替，输出码流连续，可直接写成文件；MP3 强制关闭比特池
+    kGap          // 不输出数据包，通过回调通知调用方静音区间，由调用方决定如何表示(DTX、丢弃等)
+};
+
+// 静音检测参数，构造编码器时指定。
+// 一帧内每个声道的均方根都低于 threshold_db(dBFS，满幅度正弦约为 -3 dBFS)时视为静音帧；
+// 连续静音帧数达到 hangover_frames 后才开始跳过，这些帧仍正常编码，使编码器内部延迟的样本全部是静音，
+// 跳过的帧与编码器中缓存的帧都是静音，跳过不影响前后有声部分的编码结果
+struct SilenceConfig
+{
+    SilenceMode mode            = SilenceMode::kOff;
+    double      threshold_db    = -70.0;
+    int         hangover_frames = 4; // 至少为 2，覆盖 AAC 一帧的预读与 LAME 的内部缓冲
+};
+
+// 静音检测器：用向量化的平方和内核计算编码器原生平面格式(FLTP/S16P)帧的能量
+class SilenceDetector
+{
+public:
+    SilenceDetector(const SilenceConfig& config, int channels, AVSampleFormat format);
+
+    bool Skip(const uint8_t* const* planes, int nb_samples); // 返回 true 表示这一帧不送入编码器
+    bool IsSilent(const uint8_t* const* planes, int nb_samples) const;
+    void Reset();
+
+private:
+    SilenceConfig  config_;
+    int            channels_;
+    AVSampleFormat format_;
+    double         threshold_;     // 按满幅度归一化的均方值门限
+    int            silent_frames_; // 连续静音帧数
+};
+
+#endif // __SILENCE_DETECTOR_H__
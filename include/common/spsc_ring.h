@@ -0,0 +1,212 @@
+#ifndef __SPSC_RING_H__
+#define __SPSC_RING_H__
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// 单生产者/单消费者无锁环形队列，槽位在构造时一次性分配，之后原地复用：
+// 生产者 AcquireWrite() 取得空闲槽位并填充，CommitWrite() 发布；消费者 AcquireRead() 读取，CommitRead() 归还
+// 队满时生产者等待(背压)，生产者 Close() 表示流结束，任一端 Cancel() 让两端的等待立即返回
+template <typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(size_t capacity)
+        : slots_(RoundUpPowerOfTwo(capacity))
+        , mask_(slots_.size() - 1)
+        , head_(0)
+        , cached_tail_(0)
+        , tail_(0)
+        , cached_head_(0)
+        , closed_(false)
+        , cancelled_(false)
+    {
+    }
+
+    // 所有槽位以 prototype 拷贝构造，例如预先分配好容量的缓冲区，运行时不再分配内存
+    SpscRing(size_t capacity, const T& prototype)
+        : slots_(RoundUpPowerOfTwo(capacity), prototype)
+        , mask_(slots_.size() - 1)
+        , head_(0)
+        , cached_tail_(0)
+        , tail_(0)
+        , cached_head_(0)
+        , closed_(false)
+        , cancelled_(false)
+    {
+    }
+
+    SpscRing(const SpscRing&)            = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t Capacity() const
+    {
+        return slots_.size();
+    }
+
+    // 生产者：返回下一个可写槽位，队满时返回 nullptr
+    T* AcquireWrite()
+    {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - cached_tail_ == slots_.size())
+        {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head - cached_tail_ == slots_.size())
+            {
+                return nullptr;
+            }
+        }
+
+        return &slots_[head & mask_];
+    }
+
+    void CommitWrite()
+    {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // 生产者：等待直到有空闲槽位，取消时返回 nullptr
+    T* WaitWrite()
+    {
+        for (unsigned spins = 0;; ++spins)
+        {
+            if (cancelled_.load(std::memory_order_acquire))
+            {
+                return nullptr;
+            }
+
+            T* slot = AcquireWrite();
+            if (slot)
+            {
+                return slot;
+            }
+            Backoff(spins);
+        }
+    }
+
+    // 消费者：返回下一个可读槽位，队空时返回 nullptr
+    T* AcquireRead()
+    {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == cached_head_)
+        {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail == cached_head_)
+            {
+                return nullptr;
+            }
+        }
+
+        return &slots_[tail & mask_];
+    }
+
+    void CommitRead()
+    {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // 消费者：等待直到有数据，流已结束且数据取完或被取消时返回 nullptr
+    T* WaitRead()
+    {
+        for (unsigned spins = 0;; ++spins)
+        {
+            if (cancelled_.load(std::memory_order_acquire))
+            {
+                return nullptr;
+            }
+
+            T* slot = AcquireRead();
+            if (slot)
+            {
+                return slot;
+            }
+
+            // 先读 closed_ 再重新检查队列，避免漏掉关闭前最后发布的数据
+            if (closed_.load(std::memory_order_acquire))
+            {
+                return AcquireRead();
+            }
+            Backoff(spins);
+        }
+    }
+
+    void Close()
+    {
+        closed_.store(true, std::memory_order_release);
+    }
+
+    void Cancel()
+    {
+        cancelled_.store(true, std::memory_order_release);
+    }
+
+    bool Closed() const
+    {
+        return closed_.load(std::memory_order_acquire);
+    }
+
+    bool Cancelled() const
+    {
+        return cancelled_.load(std::memory_order_acquire);
+    }
+
+    // 消费者：流已结束且数据已全部取走
+    bool Finished()
+    {
+        return closed_.load(std::memory_order_acquire) && !AcquireRead();
+    }
+
+    // 先短暂自旋，再让出时间片，长时间等待时休眠，避免空转占满核心
+    static void Backoff(unsigned spins)
+    {
+        if (spins < 64)
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            _mm_pause();
+#endif
+        }
+        else if (spins < 256)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+private:
+    static size_t RoundUpPowerOfTwo(size_t value)
+    {
+        size_t capacity = 2;
+        while (capacity < value)
+        {
+            capacity <<= 1;
+        }
+
+        return capacity;
+    }
+
+private:
+    static constexpr size_t kCacheLineSize = 64;
+
+    std::vector<T> slots_;
+    const size_t   mask_;
+
+    // 生产者与消费者各自使用的索引分处不同缓存行，避免伪共享
+    alignas(kCacheLineSize) std::atomic<size_t> head_;        // 生产者写入位置
+    size_t                                      cached_tail_; // 生产者缓存的消费位置
+    alignas(kCacheLineSize) std::atomic<size_t> tail_;        // 消费者读取位置
+    size_t                                      cached_head_; // 消费者缓存的写入位置
+    alignas(kCacheLineSize) std::atomic<bool>   closed_;
+    std::atomic<bool>                           cancelled_;
+};
+
+#endif // __SPSC_RING_H__
@@ -0,0 +1,46 @@
+#ifndef __STREAM_PARSER_H__
+#define __STREAM_PARSER_H__
+
+#include <iostream>
+#include <functional>
+#include <array>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+}
+
+// 推送式码流分帧：封装 AVCodecParserContext，接收任意长度的字节块，跨块的不完整帧由解析器内部保存。
+// 完整落在输入块内的帧直接指向调用方的数据，不经过中间缓冲区；只有输入块末尾不足
+// AV_INPUT_BUFFER_PADDING_SIZE 字节的部分拷贝到带填充的暂存区解析，满足解析器可越界读取填充字节的约定。
+// 解析器根据帧头更新 codec_context 的采样率与声道数，解码器本身逐帧跟随帧头，参数变化时无需重建
+class StreamParser
+{
+private:
+    using StreamParserFrameCallbackType = std::function<bool(const uint8_t*, size_t)>; // 返回 false 时停止解析
+
+public:
+    explicit StreamParser(AVCodecID codec_id);
+    ~StreamParser();
+
+    StreamParser(const StreamParser&)            = delete;
+    StreamParser& operator=(const StreamParser&) = delete;
+
+    // 每解析出一个完整帧调用一次 callback，帧数据只在回调期间有效
+    bool Parse(AVCodecContext* codec_context, const uint8_t* data, size_t size,
+               const StreamParserFrameCallbackType& callback);
+    // 输出解析器中缓存的最后一帧，之后可解析新的码流
+    bool Flush(AVCodecContext* codec_context, const StreamParserFrameCallbackType& callback);
+    void Reset(); // 丢弃缓存的不完整帧
+
+private:
+    bool ParseRange(AVCodecContext* codec_context, const uint8_t* data, size_t size,
+                    const StreamParserFrameCallbackType& callback);
+
+private:
+    AVCodecID             codec_id_;
+    AVCodecParserContext* parser_; // 首次解析时创建
+    std::array<uint8_t, AV_INPUT_BUFFER_PADDING_SIZE * 2> tail_; // 输入块末尾的暂存区，后半部分为填充
+};
+
+#endif // __STREAM_PARSER_H__
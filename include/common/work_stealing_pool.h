@@ -0,0 +1,53 @@
+#ifndef __WORK_STEALING_POOL_H__
+#define __WORK_STEALING_POOL_H__
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// 固定线程数的工作窃取线程池：每个工作线程拥有自己的任务队列，
+// 工作线程提交的任务进入本线程队列(LIFO执行，缓存友好)，空闲线程从其他队列头部窃取任务。
+// 分批执行后需要让出线程的任务用 Yield 重新提交，放在队列头部，排在已有任务之后执行
+class WorkStealingPool
+{
+private:
+    using TaskType = std::function<void()>;
+
+    struct WorkerQueue
+    {
+        std::mutex           mutex;
+        std::deque<TaskType> tasks;
+    };
+
+public:
+    explicit WorkStealingPool(int threads = 0); // threads <= 0 时使用全部硬件线程
+    ~WorkStealingPool();                        // 执行完已提交的任务后退出
+
+    WorkStealingPool(const WorkStealingPool&)            = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void Submit(TaskType task);
+    void Yield(TaskType task); // 放入队列头部(最先被窃取、最后被本线程执行)
+    int  ThreadCount() const;
+
+private:
+    void Push(TaskType task, bool front);
+    void WorkerThread(int index);
+    bool PopTask(int index, TaskType& task);
+
+private:
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread>                  threads_;
+    std::atomic<size_t>                       pending_;     // 已提交未执行的任务数
+    std::atomic<size_t>                       next_queue_;  // 外部线程提交时轮询选择队列
+    std::mutex                                sleep_mutex_;
+    std::condition_variable                   sleep_cond_;
+    bool                                      stop_;
+};
+
+#endif // __WORK_STEALING_POOL_H__
@@ -12,32 +12,62 @@ extern "C"
 #include <libavformat/avformat.h>
 #include <libavcodec/avcodec.h>
 #include <libavutil/opt.h>
-#include <libswresample/swresample.h>
 }
 
+#include <audio_format.h>
+#include <audio_output_converter.h>
+#include <codec_stats.h>
+#include <buffer_pool.h>
+#include <stream_parser.h>
+
 class AudioDecoderAAC
 {
 private:
-    using AACAudioDecoderCallbackType = std::function<void(uint8_t*, uint32_t)>;
+    using AACAudioDecoderCallbackType      = std::function<void(uint8_t*, uint32_t)>;
+    using AACAudioDecoderFrameCallbackType = std::function<void(const AudioFrameView&)>;
 
 public:
-    AudioDecoderAAC();
+    // 默认从每帧的 ADTS 头获取码流参数，Decode 需传入含 ADTS 头的完整帧；
+    // 指定 sample_rate/channels 时按 AAC-LC 生成 AudioSpecificConfig，Decode 传入去掉 ADTS 头的原始数据
+    explicit AudioDecoderAAC(const AudioOutputFormat& output_format = AudioOutputFormat(), int sample_rate = 0,
+                             int channels = 0);
     ~AudioDecoderAAC();
-    bool Decode(uint8_t* data, size_t size);
-    bool InstallCallback(std::function<void(uint8_t*, uint32_t)> callback);
+    bool Decode(const uint8_t* data, size_t size);
+    // 推送式解码：data 可为任意长度的字节块(如网络收到的数据)，由内部解析器分帧，跨块的不完整帧留待下次拼接；
+    // 码流须带帧头(ADTS)，采样率或声道数变化时从帧头重新获取。与 Decode 不可混用于同一码流
+    bool DecodeStream(const uint8_t* data, size_t size);
+    bool FlushStream(); // 解码解析器中缓存的最后一帧并排空解码器与重采样器，之后可推送新的码流
+    bool InstallCallback(std::function<void(uint8_t*, uint32_t)> callback);           // 交错输出格式(FLT/S16)时回调整帧数据
+    bool InstallFrameCallback(AACAudioDecoderFrameCallbackType callback); // 任意输出格式，平面格式需使用此回调
+    bool Reset();          // 丢弃解码器内部状态以便解码新的码流，输出缓冲区与回调保留
+    void ReleaseBuffers(); // 释放输出格式转换的缓冲区与重采样器，下一帧按需重新分配
+    void ClearCallbacks(); // 移除全部回调
+    void EnableStats(bool enable);                     // 开启时创建统计对象，关闭时释放；不可与编解码并发调用
+    bool GetStats(CodecStatsSnapshot& snapshot) const; // 未开启统计时返回 false，可在其他线程调用
+    void ResetStats();
+    // 开启时在输出格式转换的同一遍中测量响度与峰值，未安装回调时只测量不转换；不可与解码并发调用。
+    // 解码器原生格式不是平面浮点或平面 16 位整数时返回 false
+    bool EnableLoudness(bool enable);
+    bool GetLoudness(LoudnessSnapshot& snapshot) const; // 未开启时返回 false；在回调中调用得到截至当前帧的结果
+    CodecMemoryUsage MemoryUsage() const;               // 实例当前持有的内存，规则见 CodecMemoryUsage
+
+private:
+    bool DecodePacket(const uint8_t* data, size_t size);
+    bool ReceiveFrames();  // 取出解码器中已解码的全部帧，转换后交给回调
+    bool DrainConverter(); // 取出重采样器中的延迟样本交给回调
+    void DeliverFrame(const AudioFrameView& view);
 
 private:
-    int                         bytes_per_sample_;
-    int                         sample_rate_;
-    int                         channels_;
-    size_t                      counter_;
-    AVCodec*                    codec_;
-    AVCodecContext*             codec_context_;
-    AVFrame*                    frame_;
-    AVPacket*                   pkt_;
-    SwrContext*                 swr_ctx_;
-    std::shared_ptr<uint8_t>    adts_header_;
-    AACAudioDecoderCallbackType callback_;
+    AVCodec*                         codec_;
+    AVCodecContext*                  codec_context_;
+    AVFrame*                         frame_;
+    AVPacket*                        pkt_;
+    PacketBufferPool                 packet_pool_; // 输入包缓冲区池
+    StreamParser                     parser_;      // 推送式解码的分帧状态
+    AudioOutputConverter             output_converter_;
+    AACAudioDecoderCallbackType      callback_;
+    AACAudioDecoderFrameCallbackType frame_callback_;
+    CodecStatsHolder                 stats_; // 未开启统计时为空
 };
 
 #endif // __AUDIO_DECODER_AAC_H__
\ No newline at end of file
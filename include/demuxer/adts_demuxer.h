@@ -0,0 +1,70 @@
+#ifndef __ADTS_DEMUXER_H__
+#define __ADTS_DEMUXER_H__
+
+#include <iostream>
+#include <vector>
+
+// 一帧 ADTS 数据在源缓冲区中的视图，data/payload 均直接指向源数据，不做拷贝
+struct AdtsFrame
+{
+    const uint8_t* data;            // 含 ADTS 头的完整帧
+    size_t         size;
+    const uint8_t* payload;         // 去掉 ADTS 头(7字节，带CRC时9字节)后的原始 AAC 数据
+    size_t         payload_size;
+    int64_t        sample_position; // 本帧第一个样本在流中的位置(含编码器前置的priming样本)
+    uint32_t       samples;         // 本帧解码后的样本数
+};
+
+// 采样精确定位的结果：从 frame_index 开始解码，丢弃前 skip_samples 个输出样本即到达目标位置
+struct AdtsSeekPosition
+{
+    size_t   frame_index;
+    uint32_t skip_samples;
+};
+
+// ADTS 解复用器：对缓冲区(通常为内存映射文件)扫描一次并建立紧凑的帧索引，
+// 支持带 CRC 的 9 字节头，遇到损坏数据时自动重新同步
+class AdtsDemuxer
+{
+private:
+    struct FrameIndexEntry
+    {
+        uint64_t offset;
+        uint16_t size;
+        uint8_t  header_size;
+        uint8_t  raw_blocks; // number_of_raw_data_blocks_in_frame + 1
+        int64_t  sample_position;
+    };
+
+public:
+    AdtsDemuxer(const uint8_t* data, size_t size);
+
+    size_t  FrameCount() const;
+    bool    GetFrame(size_t index, AdtsFrame& frame) const;
+    bool    Seek(int64_t sample, size_t preroll_frames, AdtsSeekPosition& position) const;
+    int64_t TotalSamples() const;
+    int     SampleRate() const;
+    int     Channels() const;
+    int     Profile() const;        // ADTS 中的 profile_ObjectType，0 为 AAC Main，1 为 AAC LC
+    size_t  SkippedBytes() const;   // 扫描时跳过的无效字节数
+
+private:
+    void Scan();
+    bool ParseHeader(size_t offset, FrameIndexEntry& entry) const;
+    bool IsSync(size_t offset) const;
+
+private:
+    static constexpr uint32_t kSamplesPerRawBlock = 1024U;
+
+    const uint8_t*               data_;
+    size_t                       size_;
+    std::vector<FrameIndexEntry> frames_;
+    int64_t                      total_samples_;
+    uint32_t                     uniform_samples_; // 所有帧样本数相同时为该值，否则为0
+    int                          sample_rate_;
+    int                          channels_;
+    int                          profile_;
+    size_t                       skipped_bytes_;
+};
+
+#endif // __ADTS_DEMUXER_H__
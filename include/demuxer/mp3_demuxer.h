@@ -0,0 +1,77 @@
+#ifndef __MP3_DEMUXER_H__
+#define __MP3_DEMUXER_H__
+
+#include <iostream>
+#include <vector>
+
+// MPEG 音频帧头解析结果，支持 MPEG-1/2/2.5 的 Layer I/II/III
+struct Mp3FrameHeader
+{
+    int  version;     // 1: MPEG-1, 2: MPEG-2, 25: MPEG-2.5
+    int  layer;       // 1, 2, 3
+    int  bitrate;     // bit/s
+    int  sample_rate; // Hz
+    int  channels;
+    int  samples;     // 每帧样本数
+    int  frame_size;  // 含帧头的帧长(字节)
+    bool crc;         // 帧头后是否带 2 字节 CRC
+};
+
+// 一帧 MP3 数据在源缓冲区中的视图，直接指向源数据，不做拷贝
+struct Mp3Frame
+{
+    const uint8_t* data;
+    size_t         size;
+    int64_t        sample_position;
+    uint32_t       samples;
+};
+
+// MP3 解复用器：对缓冲区扫描一次建立帧索引。
+// 同步字查找使用向量化扫描，候选帧头需通过字段合法性与相邻帧一致性校验，
+// 并跳过 ID3v2/ID3v1 标签，损坏的数据只会被顺序扫描一遍而不会逐字节回退
+class Mp3Demuxer
+{
+private:
+    struct FrameIndexEntry
+    {
+        uint64_t offset;
+        uint16_t size;
+        uint16_t samples;
+        int64_t  sample_position;
+    };
+
+public:
+    Mp3Demuxer(const uint8_t* data, size_t size);
+
+    static bool ParseHeader(const uint8_t* header, Mp3FrameHeader& info);
+
+    size_t  FrameCount() const;
+    bool    GetFrame(size_t index, Mp3Frame& frame) const;
+    bool    FindFrame(int64_t sample, size_t& index) const; // 查找包含指定样本的帧
+    // 查找第 index 帧的主数据起始位置(由 Layer III 侧信息中的 main_data_begin 回溯)所在的帧，
+    // 从该帧开始解码即可填满第 index 帧所需的比特池；Layer I/II 没有比特池，返回自身
+    bool    ReservoirStart(size_t index, size_t& start) const;
+    int64_t TotalSamples() const;
+    int     SampleRate() const;
+    int     Channels() const;
+    size_t  SkippedBytes() const; // 扫描时跳过的无效字节数(不含标签)
+
+private:
+    void   Scan();
+    size_t TagSize(size_t offset) const;
+    bool   Matches(size_t offset, const Mp3FrameHeader& info) const;
+    size_t FindSync(size_t offset) const;
+    bool   ParseMainData(size_t index, uint32_t& main_data_begin, uint32_t& main_data_size) const;
+
+private:
+    const uint8_t*               data_;
+    size_t                       size_;
+    std::vector<FrameIndexEntry> frames_;
+    int64_t                      total_samples_;
+    uint32_t                     uniform_samples_; // 所有帧样本数相同时为该值，否则为0
+    int                          sample_rate_;
+    int                          channels_;
+    size_t                       skipped_bytes_;
+};
+
+#endif // __MP3_DEMUXER_H__
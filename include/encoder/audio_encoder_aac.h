@@ -13,34 +13,52 @@ extern "C"
 #include <libavcodec/avcodec.h>
 #include <libavutil/opt.h>
 #include <libswresample/swresample.h>
+#include <libavutil/audio_fifo.h>
 }
 
+#include <encoded_packet.h>
+#include <audio_encoder_core.h>
+
 class AudioEncoderAAC
 {
 private:
-    using AACAudioEncoderCallbackType = std::function<void(uint8_t*, uint32_t, uint8_t*, uint32_t)>;
+    using AACAudioEncoderCallbackType       = std::function<void(uint8_t*, uint32_t, uint8_t*, uint32_t)>;
+    using AACAudioEncoderPacketCallbackType = std::function<void(EncodedPacket&&)>;
+    using AACAudioEncoderBatchCallbackType  = std::function<void(std::vector<EncodedPacket>&)>;
+    using AACAudioEncoderGapCallbackType    = std::function<void(int64_t, int64_t)>; // 静音区间的起始时间戳与样本数
 
 public:
-    AudioEncoderAAC(int64_t bitrate, int sample_rate, int channels);
+    // noise_substitution 为 false 时关闭 PNS，码流可由 ParallelAudioDecoder 分段解码且与串行解码逐样本一致
+    // input_format 声明 Encode 接收的 PCM 格式与采样率，默认为与编码器同采样率的交错浮点
+    // silence 开启静音检测，规则见 SilenceConfig
+    AudioEncoderAAC(int64_t bitrate, int sample_rate, int channels, bool noise_substitution = true,
+                    const AudioInputFormat& input_format = AudioInputFormat(),
+                    const SilenceConfig&    silence      = SilenceConfig());
     ~AudioEncoderAAC();
-    bool Encode(uint8_t* data, size_t size);
+    bool Encode(const uint8_t* data, size_t size); // 可传入任意长度的输入格式PCM，凑满一帧即编码；不足一个样本帧的末尾字节留到下次拼接
+    bool EncodePlanar(const uint8_t* const* planes, int nb_samples); // 输入已是编码器原生的平面浮点(FLTP)格式，跳过转换
+    bool Flush();                                  // 编码剩余数据并排空编码器，之后不可再编码
     bool InstallCallback(AACAudioEncoderCallbackType callback);
+    bool InstallPacketCallback(AACAudioEncoderPacketCallbackType callback); // 逐包移交所有权，无需拷贝
+    // 批量回调：batch_packets 为 0 时每次 Encode/Flush 结束后回调一次，否则每凑满 batch_packets 个包回调一次
+    bool InstallBatchCallback(AACAudioEncoderBatchCallbackType callback, size_t batch_packets = 0);
+    // SilenceMode::kGap 时每跳过一帧回调一次，调用前先交付已缓存的批次，回调顺序与时间顺序一致
+    bool InstallGapCallback(AACAudioEncoderGapCallbackType callback);
+    int  FrameSize() const;
+    uint64_t SkippedFrames() const; // 检测为静音而未送入编码器的帧数
+    CodecMemoryUsage MemoryUsage() const; // 实例当前持有的内存，规则见 CodecMemoryUsage
+    bool Reset();          // 丢弃未输出的数据并恢复初始状态(pts 从 0 开始)，缓冲区与回调保留；返回 false 后实例不可再使用
+    void ReleaseBuffers(); // 释放 FIFO、输入帧、格式转换缓冲区与重采样器，下次送入数据时重新分配；未编码的数据一并丢弃
+    void ClearCallbacks(); // 移除全部回调
+    void EnableStats(bool enable);                     // 开启时创建统计对象，关闭时释放；不可与编解码并发调用
+    bool GetStats(CodecStatsSnapshot& snapshot) const; // 未开启统计时返回 false，可在其他线程调用
+    void ResetStats();
 
 private:
-    void UpdateAdtsHeader(AVCodecContext* codec_context, int aac_length);
+    static size_t WriteAdtsHeader(const AVCodecContext* codec_context, int payload_size, uint8_t* header);
 
 private:
-    int                         bytes_per_sample_;
-    int                         sample_rate_;
-    int                         channels_;
-    size_t                      counter_;
-    AVCodec*                    codec_;
-    AVCodecContext*             codec_context_;
-    AVFrame*                    frame_;
-    AVPacket*                   pkt_;
-    SwrContext*                 swr_ctx_;
-    std::shared_ptr<uint8_t>    adts_header_;
-    AACAudioEncoderCallbackType callback_;
+    AudioEncoderCore core_; // FIFO 分帧、静音检测、回调与统计，与 MP3 编码器共用
 };
 
-#endif // __AUDIO_ENCODER_AAC_H__
\ No newline at end of file
+#endif // __AUDIO_ENCODER_AAC_H__
@@ -0,0 +1,108 @@
+#ifndef __AUDIO_ENCODER_CORE_H__
+#define __AUDIO_ENCODER_CORE_H__
+
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <array>
+
+extern "C"
+{
+#include <libavcodec/avcodec.h>
+#include <libavutil/opt.h>
+#include <libavutil/audio_fifo.h>
+}
+
+#include <encoded_packet.h>
+#include <buffer_pool.h>
+#include <audio_input_converter.h>
+#include <codec_stats.h>
+#include <silence_detector.h>
+
+// AAC/MP3 编码器共用的编码流程：输入格式转换与 FIFO 分帧、静音检测与跳帧、时间戳重排、
+// 数据包的逐包/批量/原始回调、Reset/ReleaseBuffers 与内存统计。
+// 编码器之间的差异由构造时传入的函数描述：打开编码器前设置私有参数，以及为每个数据包写入头部(AAC 的 ADTS 头)
+class AudioEncoderCore
+{
+public:
+    static constexpr size_t kMaxHeaderSize = 7U;
+
+    using CallbackType       = std::function<void(uint8_t*, uint32_t, uint8_t*, uint32_t)>; // 头部(可为空)与负载
+    using PacketCallbackType = std::function<void(EncodedPacket&&)>;
+    using BatchCallbackType  = std::function<void(std::vector<EncodedPacket>&)>;
+    using GapCallbackType    = std::function<void(int64_t, int64_t)>; // 静音区间的起始时间戳与样本数
+    // 打开编码器前调用，设置编码器的私有参数
+    using ConfigureFunctionType = std::function<void(AVCodecContext*)>;
+    // 写入负载为 payload_size 字节的数据包的头部，返回头部字节数(不超过 kMaxHeaderSize)
+    using HeaderFunctionType = std::function<size_t(const AVCodecContext*, int payload_size, uint8_t* header)>;
+
+    AudioEncoderCore(AVCodecID codec_id, const char* name, AVSampleFormat sample_format, int64_t bitrate,
+                     int sample_rate, int channels, const AudioInputFormat& input_format,
+                     const SilenceConfig& silence, ConfigureFunctionType configure,
+                     HeaderFunctionType header = nullptr);
+    ~AudioEncoderCore();
+
+    AudioEncoderCore(const AudioEncoderCore&)            = delete;
+    AudioEncoderCore& operator=(const AudioEncoderCore&) = delete;
+
+    bool Encode(const uint8_t* data, size_t size);
+    bool EncodePlanar(const uint8_t* const* planes, int nb_samples);
+    bool Flush();
+    bool InstallCallback(CallbackType callback);
+    bool InstallPacketCallback(PacketCallbackType callback);
+    bool InstallBatchCallback(BatchCallbackType callback, size_t batch_packets);
+    bool InstallGapCallback(GapCallbackType callback);
+    int  FrameSize() const;
+    uint64_t SkippedFrames() const;
+    CodecMemoryUsage MemoryUsage(size_t instance_size) const; // instance_size 为包含本对象的编码器大小
+    bool Reset();
+    void ReleaseBuffers();
+    void ClearCallbacks();
+    void EnableStats(bool enable);
+    bool GetStats(CodecStatsSnapshot& snapshot) const;
+    void ResetStats();
+
+private:
+    bool OpenCodec();
+    bool EncodeFifoFrames(bool flush);
+    bool AllocateFifo();
+    bool SendFrame(AVFrame* frame);
+    void DeliverPacket();
+    bool SkipFrame();
+    bool EncodeSilentPacket();
+    void DeliverBatch();
+
+private:
+    AVSampleFormat              sample_format_; // 编码器原生的平面格式
+    int64_t                     bitrate_;
+    int                         sample_rate_;
+    int                         channels_;
+    size_t                      counter_;
+    AVCodec*                    codec_;
+    AVCodecContext*             codec_context_;
+    AVFrame*                    frame_;
+    AVPacket*                   pkt_;
+    PacketBufferPool            packet_pool_; // 输出包缓冲区池，编码器支持 DR1 时生效
+    std::unique_ptr<AudioFramePool> frame_pool_;  // 输入帧缓冲区池
+    AudioInputConverter         input_converter_;
+    AVAudioFifo*                fifo_;        // 首次送入数据时分配
+    bool                        flushed_;
+    ConfigureFunctionType       configure_;
+    HeaderFunctionType          header_function_;
+    std::array<uint8_t, kMaxHeaderSize> header_;
+    CallbackType                      callback_;
+    PacketCallbackType                packet_callback_;
+    BatchCallbackType                 batch_callback_;
+    size_t                            batch_packets_;
+    std::vector<EncodedPacket>        batch_;
+    CodecStatsHolder                  stats_; // 未开启统计时为空
+    std::unique_ptr<SilenceDetector>  silence_;       // 未开启静音检测时为空
+    SilenceMode                       silence_mode_;
+    AVPacket*                         silent_packet_; // 预先编码的静音帧，仅 kCachedFrame 时有效
+    int64_t                           next_pts_;      // 开启静音检测时下一个输出包的时间戳
+    uint64_t                          skipped_frames_;
+    GapCallbackType                   gap_callback_;
+};
+
+#endif // __AUDIO_ENCODER_CORE_H__
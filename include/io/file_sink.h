@@ -0,0 +1,57 @@
+#ifndef __FILE_SINK_H__
+#define __FILE_SINK_H__
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include <sys/uio.h>
+
+// 持久打开的文件输出端：文件只打开一次，数据先写入用户态缓冲区，
+// 缓冲区满时通过 writev 将缓冲区与当前数据一次性写出，
+// 可选后台刷新线程（双缓冲）使编码线程不阻塞在磁盘 I/O 上
+class FileSink
+{
+public:
+    static constexpr size_t kDefaultBufferSize = 1U << 20; // 默认 1MB 用户态缓冲区
+
+    FileSink(const std::string& path, size_t buffer_size = kDefaultBufferSize, bool async_flush = false,
+             bool append = false);
+    ~FileSink();
+
+    FileSink(const FileSink&)            = delete;
+    FileSink& operator=(const FileSink&) = delete;
+
+    bool     Write(const uint8_t* data, size_t size);
+    bool     Write(const uint8_t* header, size_t header_size, const uint8_t* data, size_t data_size);
+    bool     Flush();
+    bool     Close();
+    uint64_t BytesWritten() const;
+
+private:
+    bool WriteVector(struct iovec* iov, int iovcnt);
+    bool WriteSync(const struct iovec* iov, int iovcnt, size_t total);
+    bool WriteAsync(const struct iovec* iov, int iovcnt);
+    bool SubmitFrontBuffer();
+    void FlushThread();
+
+private:
+    int                     fd_;
+    size_t                  buffer_size_;
+    bool                    async_flush_;
+    std::vector<uint8_t>    front_buffer_; // 调用线程写入的缓冲区
+    std::vector<uint8_t>    back_buffer_;  // 后台线程正在写出的缓冲区
+    bool                    back_pending_;
+    bool                    stop_;
+    bool                    failed_;
+    std::atomic<uint64_t>   bytes_written_;
+    std::mutex              mutex_;
+    std::condition_variable cond_;
+    std::thread             flush_thread_;
+};
+
+#endif // __FILE_SINK_H__
@@ -0,0 +1,36 @@
+#ifndef __MAPPED_FILE_H__
+#define __MAPPED_FILE_H__
+
+#include <iostream>
+#include <string>
+
+// 只读内存映射文件：输入文件直接映射到进程地址空间，编解码器读取映射内的指针，
+// 不经过内核到用户缓冲区的拷贝，也不需要逐帧分配内存。
+// 映射末尾保证至少有 kTailPadding 个可读的零字节，满足 libavcodec 对输入缓冲区
+// AV_INPUT_BUFFER_PADDING_SIZE 的要求，文件最后一帧也可以直接送入解码器。
+class MappedFile
+{
+public:
+    static constexpr size_t kTailPadding = 64U;
+
+    explicit MappedFile(const std::string& path, bool sequential = true);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* Data() const;
+    size_t         Size() const;
+    void           WillNeed(size_t offset, size_t size); // 预读即将访问的区域
+    void           DontNeed(size_t offset, size_t size); // 释放已处理区域占用的物理页
+
+private:
+    void Advise(size_t offset, size_t size, int advice);
+
+private:
+    uint8_t* data_;
+    size_t   size_;
+    size_t   mapping_size_; // 含尾部填充并按页对齐后的映射长度
+};
+
+#endif // __MAPPED_FILE_H__
@@ -0,0 +1,88 @@
+#ifndef __MULTI_RENDITION_ENCODER_H__
+#define __MULTI_RENDITION_ENCODER_H__
+
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+extern "C"
+{
+#include <libavutil/samplefmt.h>
+}
+
+#include <audio_format.h>
+#include <encoded_packet.h>
+#include <work_stealing_pool.h>
+
+class AudioEncoderAAC;
+class AudioEncoderMP3;
+
+// 多码率(ABR 阶梯)编码：同一路交错浮点PCM只输入一次，
+// 每种目标采样格式(AAC 为 FLTP，MP3 为 S16P)只用 SIMD 内核做一次解交错/格式转换，
+// 转换结果由该格式的所有码率共享，各码率在线程池上并行编码。
+// 输入可在样本帧中间结束，剩余字节与下次 Encode 的开头拼接，Flush 时丢弃不完整的样本帧。
+// 所有码率每次收到完全相同的样本，同一编码格式的各码率第 k 个数据包覆盖相同的时间范围，
+// 分片边界在整个阶梯上保持一致。
+class MultiRenditionEncoder
+{
+private:
+    // 参数为码率序号(AddRendition 的返回值)与数据包；不同码率的回调可能在不同线程上并发执行，
+    // 同一码率的回调按顺序串行执行
+    using MultiRenditionEncoderCallbackType = std::function<void(int, EncodedPacket&&)>;
+
+    struct ConvertTarget
+    {
+        AVSampleFormat        format;
+        std::vector<uint8_t*> planes;
+    };
+
+    struct Rendition
+    {
+        AudioCodecType                   codec;
+        int64_t                          bitrate;
+        std::shared_ptr<AudioEncoderAAC> aac_encoder;
+        std::shared_ptr<AudioEncoderMP3> mp3_encoder;
+        size_t                           target; // 使用的转换结果序号
+        bool                             ok;
+    };
+
+public:
+    MultiRenditionEncoder(int sample_rate, int channels, int threads = 0);
+    ~MultiRenditionEncoder();
+
+    MultiRenditionEncoder(const MultiRenditionEncoder&)            = delete;
+    MultiRenditionEncoder& operator=(const MultiRenditionEncoder&) = delete;
+
+    int  AddRendition(AudioCodecType codec, int64_t bitrate); // 返回码率序号，失败返回 -1；须在 Encode 之前调用
+    bool Encode(const uint8_t* data, size_t size);            // 任意长度的交错浮点PCM，阻塞至全部码率编码完成
+    bool Flush();
+    bool InstallCallback(MultiRenditionEncoderCallbackType callback);
+    int  RenditionCount() const;
+
+private:
+    bool EncodeSlice(const uint8_t* data, int samples); // 转换后分发给全部码率，samples 不超过 kSliceSamples
+    void Convert(const uint8_t* data, int samples);
+    bool RunRenditions(std::function<bool(Rendition&)> task);
+    bool AddTarget(AVSampleFormat format, size_t& index);
+
+private:
+    static constexpr int kSliceSamples = 16384; // 每次转换并分发的样本数，限制转换缓冲区大小
+
+    int                               sample_rate_;
+    int                               channels_;
+    std::vector<ConvertTarget>        targets_;
+    std::vector<uint8_t>              carry_;     // 上次输入末尾不足一个样本帧的字节
+    std::vector<Rendition>            renditions_;
+    WorkStealingPool                  pool_;
+    std::mutex                        mutex_;
+    std::condition_variable           cond_;
+    size_t                            remaining_; // 当前批次未完成的码率数
+    bool                              started_;
+    bool                              flushed_;
+    MultiRenditionEncoderCallbackType callback_;
+};
+
+#endif // __MULTI_RENDITION_ENCODER_H__
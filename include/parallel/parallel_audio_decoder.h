@@ -0,0 +1,77 @@
+#ifndef __PARALLEL_AUDIO_DECODER_H__
+#define __PARALLEL_AUDIO_DECODER_H__
+
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+#include <audio_format.h>
+
+class AdtsDemuxer;
+
+// 离线并行解码：按帧索引将整段码流切分为若干分段，每个分段由独立的解码器实例在工作线程上解码，
+// 再按顺序拼接输出的 PCM。MP3 与未使用 PNS 的 AAC LC 码流的结果与串行解码逐样本一致。
+//
+// 分段边界的处理：
+//   - 每个分段从前面 preroll_frames 帧开始解码，使重叠相加与合成滤波器状态在分段起点与串行解码一致，
+//     预热帧的输出被丢弃；
+//   - MP3 Layer III 的帧可从前面帧的比特池借用主数据，预热范围还需向前延伸到分段前一帧的
+//     main_data_begin 所指的帧，保证该帧完整解码，预热帧数随码率与比特池使用情况变化；
+//   - 解码器在送入第 k 帧时输出第 k 帧的样本，输出按所属输入帧判断是否保留；
+//   - 已解码未输出的分段数有上限，长时间的录音也只占用固定的内存。
+//   - AAC 的 PNS 频带噪声来自解码器内跨帧延续的随机数状态，分段解码时这些频带的噪声与串行解码不同(能量相同)；
+//     PNS 无法从帧头判断，调用方需确认码流未使用 PNS(本工程的 AAC 编码器以 noise_substitution 为 false 构造时关闭)；
+//   - 非 LC 的 profile(Main 的预测器状态跨越整段码流)以及 SBR/PS(HE-AAC)的状态无法由预热恢复，
+//     这类码流由 profile 与首帧解码输出的样本数、声道数识别，退回串行解码。
+// 只支持交错输出且不重采样；S16 输出需关闭抖动才能与串行解码逐样本一致。
+class ParallelAudioDecoder
+{
+private:
+    // 每次回调一帧交错 PCM
+    using ParallelAudioDecoderCallbackType = std::function<void(uint8_t*, uint32_t)>;
+
+    struct SegmentResult
+    {
+        bool                 done;
+        bool                 ok;
+        std::vector<uint8_t> bytes;   // 保留的全部 PCM
+        std::vector<size_t>  offsets; // 每帧在 bytes 中的起始位置
+    };
+
+public:
+    explicit ParallelAudioDecoder(const AudioOutputFormat& output_format = AudioOutputFormat(), int threads = 0,
+                                  int preroll_frames = 2);
+    ~ParallelAudioDecoder();
+    bool DecodeAdts(const uint8_t* data, size_t size); // 解码整段 ADTS 码流，阻塞至全部输出回调完成
+    bool DecodeMp3(const uint8_t* data, size_t size);  // 解码整段 MP3 码流，阻塞至全部输出回调完成
+    bool InstallCallback(ParallelAudioDecoderCallbackType callback);
+
+private:
+    // 从 pre_begin 开始解码，只保留 [frame_begin, frame_end) 各帧的输出
+    bool AdtsSegmentable(const AdtsDemuxer& demuxer) const; // 是否为可分段解码的 AAC LC 码流
+    // 单个解码器按顺序解码全部帧，输出直接交给回调
+    template <typename Decoder, typename Frame, typename Demuxer>
+    bool DecodeSerial(const Demuxer& demuxer);
+    template <typename Decoder, typename Frame, typename Demuxer>
+    void DecodeSegment(const Demuxer& demuxer, size_t index, size_t pre_begin, size_t frame_begin, size_t frame_end);
+    bool Run(size_t total_frames, const std::function<void(size_t, size_t, size_t)>& decode_segment);
+    void FinishSegment(size_t index, SegmentResult&& result);
+
+private:
+    AudioOutputFormat                output_format_;
+    int                              threads_;
+    int                              preroll_frames_;
+    size_t                           segment_frames_; // 每个分段的帧数
+    std::vector<SegmentResult>       segments_;
+    size_t                           next_segment_;   // 下一个待解码的分段
+    size_t                           delivered_;      // 已输出的分段数
+    bool                             abort_;
+    std::mutex                       mutex_;
+    std::condition_variable          cond_;
+    ParallelAudioDecoderCallbackType callback_;
+};
+
+#endif // __PARALLEL_AUDIO_DECODER_H__
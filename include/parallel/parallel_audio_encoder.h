@@ -0,0 +1,64 @@
+#ifndef __PARALLEL_AUDIO_ENCODER_H__
+#define __PARALLEL_AUDIO_ENCODER_H__
+
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+#include <audio_format.h>
+
+// 离线并行编码：将整段交错浮点PCM按编码帧边界切分为若干分段，
+// 每个分段由独立的编码器实例在工作线程上编码，再按顺序拼接输出。
+//
+// 分段边界的处理：
+//   - 每个分段额外编码前面 preroll_frames 帧(预热)和后面 preroll_frames 帧(前瞻)，
+//     使边界处编码器的心理声学状态与串行编码一致，多余的数据包被丢弃；
+//   - 编码器每输入一帧输出一个数据包且延迟固定，因此第 k 个数据包对应的时间位置可以直接由
+//     分段起点推算，拼接后的帧数与时间轴与串行编码完全一致；
+//   - MP3 分段编码时关闭比特池，保证帧不会引用其他编码器实例输出的字节。
+class ParallelAudioEncoder
+{
+private:
+    // 每次回调一个完整的帧(AAC 为含 ADTS 头的完整帧)
+    using ParallelAudioEncoderCallbackType = std::function<void(uint8_t*, uint32_t)>;
+
+    struct SegmentResult
+    {
+        bool                 done;
+        bool                 ok;
+        std::vector<uint8_t> bytes;   // 分段编码器输出的全部字节
+        std::vector<size_t>  offsets; // 每个数据包在 bytes 中的起始位置
+        size_t               first;   // 保留的第一个数据包序号
+        size_t               last;    // 保留的最后一个数据包序号(不含)
+    };
+
+public:
+    ParallelAudioEncoder(AudioCodecType codec, int64_t bitrate, int sample_rate, int channels, int threads = 0,
+                         int preroll_frames = 8);
+    ~ParallelAudioEncoder();
+    bool Encode(const uint8_t* data, size_t size); // 编码整段PCM，阻塞至全部输出回调完成
+    bool InstallCallback(ParallelAudioEncoderCallbackType callback);
+
+private:
+    void EncodeSegment(const uint8_t* data, size_t total_samples, size_t index, size_t frame_begin,
+                       size_t frame_end, bool last);
+
+private:
+    AudioCodecType                   codec_;
+    int64_t                          bitrate_;
+    int                              sample_rate_;
+    int                              channels_;
+    int                              threads_;
+    int                              preroll_frames_;
+    int                              frame_size_;
+    size_t                           segment_frames_; // 每个分段的最小帧数
+    std::vector<SegmentResult>       segments_;
+    std::mutex                       mutex_;
+    std::condition_variable          cond_;
+    ParallelAudioEncoderCallbackType callback_;
+};
+
+#endif // __PARALLEL_AUDIO_ENCODER_H__
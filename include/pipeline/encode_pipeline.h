@@ -0,0 +1,80 @@
+#ifndef __ENCODE_PIPELINE_H__
+#define __ENCODE_PIPELINE_H__
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <atomic>
+#include <string>
+
+#include <audio_encoder_aac.h>
+#include <audio_encoder_mp3.h>
+#include <encoded_packet.h>
+#include <file_sink.h>
+#include <spsc_ring.h>
+
+// 流水线编码：读取、编码、写出分别运行在不同线程上，级间以预分配槽位的 SPSC 无锁环形队列连接
+//   读取线程(调用 Run 的线程) --PCM块--> 每路一个编码线程 --数据包--> 写出线程
+// 队列满时上游等待(背压)，上游结束后关闭队列，下游取完剩余数据后退出；任一级出错时取消全部队列
+// 注册到流水线的编码器由流水线独占使用，Run 返回前不可在其他线程调用；
+// 流水线在编码器上安装的回调引用自身，Run 结束或流水线析构时移除编码器的全部回调，之后编码器可以继续单独使用
+class EncodePipeline
+{
+private:
+    using EncodeFunctionType = std::function<bool(const uint8_t*, size_t)>;
+    using FlushFunctionType  = std::function<bool()>;
+
+    struct PcmChunk
+    {
+        std::vector<uint8_t> data;
+        size_t               size;
+    };
+
+    struct Stream
+    {
+        std::string                              name;
+        std::shared_ptr<AudioEncoderAAC>         aac_encoder; // 两者之一有效
+        std::shared_ptr<AudioEncoderMP3>         mp3_encoder;
+        EncodeFunctionType                       encode;
+        FlushFunctionType                        flush;
+        std::shared_ptr<FileSink>                sink;
+        std::unique_ptr<SpscRing<PcmChunk>>      input;
+        std::unique_ptr<SpscRing<EncodedPacket>> packets;
+    };
+
+public:
+    static constexpr size_t kDefaultChunkSize   = 64U * 1024U;
+    static constexpr size_t kDefaultInputSlots  = 16U;
+    static constexpr size_t kDefaultPacketSlots = 256U;
+
+    EncodePipeline(size_t chunk_size = kDefaultChunkSize, size_t input_slots = kDefaultInputSlots,
+                   size_t packet_slots = kDefaultPacketSlots);
+    ~EncodePipeline();
+
+    EncodePipeline(const EncodePipeline&)            = delete;
+    EncodePipeline& operator=(const EncodePipeline&) = delete;
+
+    bool AddAACStream(std::shared_ptr<AudioEncoderAAC> encoder, std::shared_ptr<FileSink> sink);
+    bool AddMP3Stream(std::shared_ptr<AudioEncoderMP3> encoder, std::shared_ptr<FileSink> sink);
+    bool Run(const uint8_t* data, size_t size); // 编码全部输入并刷新编码器，数据写入各路输出后返回
+
+private:
+    Stream* AddStream(const std::string& name, std::shared_ptr<FileSink> sink);
+    void    PushPacket(Stream* stream, EncodedPacket&& packet);
+    bool    ReadStage(const uint8_t* data, size_t size);
+    void    EncodeStage(Stream* stream);
+    void    WriteStage();
+    void    Cancel();
+    void    ClearCallbacks(); // 移除安装在各路编码器上的回调
+
+private:
+    size_t                               chunk_size_;
+    size_t                               input_slots_;
+    size_t                               packet_slots_;
+    std::vector<std::unique_ptr<Stream>> streams_;
+    std::atomic<bool>                    failed_;
+    bool                                 ran_;
+};
+
+#endif // __ENCODE_PIPELINE_H__
@@ -0,0 +1,82 @@
+#ifndef __STREAM_SCHEDULER_H__
+#define __STREAM_SCHEDULER_H__
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include <work_stealing_pool.h>
+
+// 多路流调度器：持有大量编码器/解码器实例，每路流通过队列接收数据，
+// 在固定大小的工作窃取线程池上处理，同一路流任意时刻只在一个线程上执行，保证流内顺序。
+// 编码流每次可推入任意长度的交错浮点PCM，解码流每次推入一个完整的压缩帧。
+class StreamScheduler
+{
+private:
+    using AACEncoderCallbackType = std::function<void(uint8_t*, uint32_t, uint8_t*, uint32_t)>;
+    using MP3EncoderCallbackType = std::function<void(uint8_t*, uint32_t)>;
+    using DecoderCallbackType    = std::function<void(uint8_t*, uint32_t)>;
+    using ProcessType            = std::function<bool(const uint8_t*, size_t)>;
+    using FlushType              = std::function<bool()>;
+
+    struct Stream
+    {
+        std::mutex                       mutex;
+        std::deque<std::vector<uint8_t>> queue;
+        size_t                           queued_bytes;
+        bool                             scheduled; // 已提交到线程池或正在执行
+        bool                             closing;
+        std::atomic<uint64_t>            processed_chunks;
+        std::atomic<uint64_t>            errors;
+        std::shared_ptr<void>            codec; // 持有编解码器实例
+        ProcessType                      process;
+        FlushType                        flush;
+    };
+
+public:
+    struct StreamBacklog
+    {
+        size_t   queued_chunks;    // 等待处理的数据块数
+        size_t   queued_bytes;     // 等待处理的字节数
+        uint64_t processed_chunks; // 已处理的数据块数
+        uint64_t errors;           // 处理失败的数据块数
+    };
+
+    explicit StreamScheduler(int threads = 0);
+    ~StreamScheduler(); // 等待所有已推入的数据处理完成
+
+    int  AddAACEncoderStream(int64_t bitrate, int sample_rate, int channels, AACEncoderCallbackType callback);
+    int  AddMP3EncoderStream(int64_t bitrate, int sample_rate, int channels, MP3EncoderCallbackType callback);
+    int  AddAACDecoderStream(DecoderCallbackType callback);
+    int  AddMP3DecoderStream(DecoderCallbackType callback);
+    bool Push(int stream_id, const uint8_t* data, size_t size);
+    bool Push(int stream_id, std::vector<uint8_t>&& chunk);
+    bool CloseStream(int stream_id); // 处理完已推入的数据后冲刷编解码器并移除该流
+    bool GetBacklog(int stream_id, StreamBacklog& backlog);
+    void WaitIdle();
+
+private:
+    int                     AddStream(std::shared_ptr<Stream> stream);
+    std::shared_ptr<Stream> FindStream(int stream_id);
+    void                    Schedule(int stream_id, const std::shared_ptr<Stream>& stream, bool yield = false);
+    void                    RunStream(int stream_id, std::shared_ptr<Stream> stream);
+
+private:
+    static constexpr size_t kBatchChunks = 8U; // 每次调度最多处理的数据块数，避免单路流长期占用线程
+
+    std::mutex                                       streams_mutex_;
+    std::unordered_map<int, std::shared_ptr<Stream>> streams_;
+    int                                              next_stream_id_;
+    std::mutex                                       idle_mutex_;
+    std::condition_variable                          idle_cond_;
+    size_t                                           active_streams_; // 已调度未完成的流数
+    WorkStealingPool                                 pool_;
+};
+
+#endif // __STREAM_SCHEDULER_H__
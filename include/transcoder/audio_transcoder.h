@@ -0,0 +1,61 @@
+#ifndef __AUDIO_TRANSCODER_H__
+#define __AUDIO_TRANSCODER_H__
+
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <memory>
+
+#include <audio_format.h>
+#include <encoded_packet.h>
+#include <audio_encoder_aac.h>
+#include <audio_encoder_mp3.h>
+#include <audio_decoder_aac.h>
+#include <audio_decoder_mp3.h>
+
+// 内存中的 AAC/MP3 转码器：解码器以平面浮点输出，帧数据不经交错直接写入编码器的 FIFO，
+// 由 FIFO 适配两种编码的帧长(1024/1152)；只有目标编码器需要 S16P(MP3)时才做一次平面格式转换。
+// 编码器在解码出第一帧、得知采样率与声道数后才创建，之后码流参数变化视为错误
+class AudioTranscoder
+{
+private:
+    using AudioTranscoderPacketCallbackType = std::function<void(EncodedPacket&&)>;
+
+public:
+    // source_sample_rate/source_channels 只对 AAC 输入有效，含义同 AudioDecoderAAC 的构造参数
+    AudioTranscoder(AudioCodecType source, AudioCodecType target, int64_t bitrate, int source_sample_rate = 0,
+                    int source_channels = 0);
+    ~AudioTranscoder();
+
+    AudioTranscoder(const AudioTranscoder&)            = delete;
+    AudioTranscoder& operator=(const AudioTranscoder&) = delete;
+
+    bool Transcode(const uint8_t* data, size_t size); // 传入一个完整的压缩帧，格式同对应解码器的 Decode
+    bool Flush();                                     // 排空解码器与重采样器，编码剩余数据并排空编码器，之后不可再转码
+    bool InstallPacketCallback(AudioTranscoderPacketCallbackType callback); // AAC 输出包携带 ADTS 头
+    int  SampleRate() const; // 编码器创建前返回 0
+    int  Channels() const;
+
+private:
+    bool EncodeFrame(const AudioFrameView& frame);
+    bool CreateEncoder(int sample_rate, int channels);
+    void DeliverPacket(EncodedPacket&& packet);
+
+private:
+    AudioCodecType                    source_;
+    AudioCodecType                    target_;
+    int64_t                           bitrate_;
+    int                               sample_rate_;
+    int                               channels_;
+    bool                              failed_;  // 解码回调中的编码错误，由 Transcode 返回
+    bool                              flushed_;
+    std::unique_ptr<AudioDecoderAAC>  aac_decoder_;
+    std::unique_ptr<AudioDecoderMP3>  mp3_decoder_;
+    std::unique_ptr<AudioEncoderAAC>  aac_encoder_;
+    std::unique_ptr<AudioEncoderMP3>  mp3_encoder_;
+    std::vector<int16_t>              s16_buffer_; // FLTP -> S16P 的转换缓冲区，只增不减
+    std::vector<uint8_t*>             s16_planes_;
+    AudioTranscoderPacketCallbackType callback_;
+};
+
+#endif // __AUDIO_TRANSCODER_H__
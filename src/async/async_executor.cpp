@@ -0,0 +1,117 @@
+#include <async_executor.h>
+
+AsyncExecutor::AsyncExecutor(int threads)
+    : dispatcher_(nullptr)
+    , pool_(threads)
+{
+}
+
+AsyncExecutor::~AsyncExecutor()
+{
+}
+
+void AsyncExecutor::Submit(TaskType task)
+{
+    pool_.Submit(std::move(task));
+}
+
+void AsyncExecutor::Yield(TaskType task)
+{
+    pool_.Yield(std::move(task));
+}
+
+bool AsyncExecutor::InstallResumeDispatcher(AsyncResumeDispatcherType dispatcher)
+{
+    if (!dispatcher)
+    {
+        return false;
+    }
+
+    dispatcher_ = dispatcher;
+
+    return true;
+}
+
+void AsyncExecutor::Resume(std::coroutine_handle<> handle)
+{
+    if (dispatcher_)
+    {
+        dispatcher_(handle);
+        return;
+    }
+
+    handle.resume();
+}
+
+int AsyncExecutor::ThreadCount() const
+{
+    return pool_.ThreadCount();
+}
+
+AsyncStrand::AsyncStrand(AsyncExecutor& executor)
+    : executor_(executor)
+    , state_(std::make_shared<State>())
+{
+    state_->scheduled = false;
+}
+
+void AsyncStrand::Post(TaskType task)
+{
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->tasks.push_back(std::move(task));
+        if (!state_->scheduled)
+        {
+            state_->scheduled = true;
+            schedule          = true;
+        }
+    }
+
+    if (schedule)
+    {
+        AsyncExecutor*         executor = &executor_;
+        std::shared_ptr<State> state    = state_;
+        executor_.Submit([executor, state]() { Run(executor, state); });
+    }
+}
+
+AsyncExecutor& AsyncStrand::Executor() const
+{
+    return executor_;
+}
+
+void AsyncStrand::Run(AsyncExecutor* executor, std::shared_ptr<State> state)
+{
+    for (size_t i = 0; i < kBatchTasks; ++i)
+    {
+        TaskType task;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            if (state->tasks.empty())
+            {
+                state->scheduled = false;
+                return;
+            }
+
+            task = std::move(state->tasks.front());
+            state->tasks.pop_front();
+        }
+
+        // 工作中恢复的协程可能继续向本序列投递，投递只入队，由本循环或下一次调度执行
+        task();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (state->tasks.empty())
+        {
+            state->scheduled = false;
+            return;
+        }
+    }
+
+    // 仍有积压则重新入队到队列头部，排在本线程已有的其他序列之后执行；
+    // 用 Submit 会放在本地队列尾部而被立即取回，其他序列得不到执行
+    executor->Yield([executor, state]() { Run(executor, state); });
+}
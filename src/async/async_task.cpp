@@ -0,0 +1,94 @@
+#include <async_task.h>
+
+#include <mutex>
+#include <condition_variable>
+
+namespace
+{
+// 立即开始执行、结束时自行销毁的协程，用于启动顶层 Task
+struct DetachedTask
+{
+    struct promise_type
+    {
+        DetachedTask get_return_object() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void() noexcept
+        {
+        }
+
+        void unhandled_exception() noexcept
+        {
+        }
+    };
+};
+
+struct WaitState
+{
+    std::mutex              mutex;
+    std::condition_variable cond;
+    bool                    done = false;
+    std::exception_ptr      exception;
+};
+
+DetachedTask RunDetached(Task<void> task)
+{
+    try
+    {
+        co_await task;
+    }
+    catch (...)
+    {
+    }
+}
+
+DetachedTask RunAndSignal(Task<void> task, WaitState& state)
+{
+    std::exception_ptr exception;
+    try
+    {
+        co_await task;
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    // 持锁通知，等待方在本协程释放锁之前不会返回并销毁 state
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.exception = exception;
+    state.done      = true;
+    state.cond.notify_all();
+}
+} // namespace
+
+void Spawn(Task<void> task)
+{
+    RunDetached(std::move(task));
+}
+
+void SyncWait(Task<void> task)
+{
+    WaitState state;
+    RunAndSignal(std::move(task), state);
+
+    std::unique_lock<std::mutex> lock(state.mutex);
+    state.cond.wait(lock, [&state]() { return state.done; });
+
+    if (state.exception)
+    {
+        std::rethrow_exception(state.exception);
+    }
+}
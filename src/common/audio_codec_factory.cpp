@@ -0,0 +1,75 @@
+#include <audio_codec_factory.h>
+#include <audio_encoder_aac.h>
+#include <audio_encoder_mp3.h>
+#include <audio_decoder_aac.h>
+#include <audio_decoder_mp3.h>
+
+AudioCodecFactory::AudioCodecFactory(size_t max_idle_per_key, bool release_idle_buffers)
+    : aac_encoders_(
+          [](const AudioCodecKey& key) {
+              return std::unique_ptr<AudioEncoderAAC>(new AudioEncoderAAC(key.bitrate, key.sample_rate, key.channels));
+          },
+          max_idle_per_key, release_idle_buffers)
+    , mp3_encoders_(
+          [](const AudioCodecKey& key) {
+              return std::unique_ptr<AudioEncoderMP3>(new AudioEncoderMP3(key.bitrate, key.sample_rate, key.channels));
+          },
+          max_idle_per_key, release_idle_buffers)
+    , aac_decoders_(
+          [](const AudioCodecKey& key) {
+              return std::unique_ptr<AudioDecoderAAC>(
+                  new AudioDecoderAAC(key.output_format, key.sample_rate, key.channels));
+          },
+          max_idle_per_key, release_idle_buffers)
+    , mp3_decoders_(
+          [](const AudioCodecKey& key) {
+              return std::unique_ptr<AudioDecoderMP3>(new AudioDecoderMP3(key.output_format));
+          },
+          max_idle_per_key, release_idle_buffers)
+{
+}
+
+AudioCodecFactory::~AudioCodecFactory()
+{
+}
+
+std::shared_ptr<AudioEncoderAAC> AudioCodecFactory::AcquireAACEncoder(int64_t bitrate, int sample_rate, int channels)
+{
+    return aac_encoders_.Acquire({AudioCodecType::kAAC, sample_rate, channels, bitrate, AudioOutputFormat()});
+}
+
+std::shared_ptr<AudioEncoderMP3> AudioCodecFactory::AcquireMP3Encoder(int64_t bitrate, int sample_rate, int channels)
+{
+    return mp3_encoders_.Acquire({AudioCodecType::kMP3, sample_rate, channels, bitrate, AudioOutputFormat()});
+}
+
+std::shared_ptr<AudioDecoderAAC> AudioCodecFactory::AcquireAACDecoder(int sample_rate, int channels,
+                                                                      const AudioOutputFormat& output_format)
+{
+    return aac_decoders_.Acquire({AudioCodecType::kAAC, sample_rate, channels, 0, output_format});
+}
+
+std::shared_ptr<AudioDecoderMP3> AudioCodecFactory::AcquireMP3Decoder(const AudioOutputFormat& output_format)
+{
+    // MP3 解码器的参数全部来自码流，只按输出格式区分
+    return mp3_decoders_.Acquire({AudioCodecType::kMP3, 0, 0, 0, output_format});
+}
+
+size_t AudioCodecFactory::PrewarmEncoders(AudioCodecType codec, int64_t bitrate, int sample_rate, int channels,
+                                          size_t count)
+{
+    AudioCodecKey key = {codec, sample_rate, channels, bitrate, AudioOutputFormat()};
+
+    return AudioCodecType::kAAC == codec ? aac_encoders_.Prewarm(key, count) : mp3_encoders_.Prewarm(key, count);
+}
+
+size_t AudioCodecFactory::PrewarmDecoders(AudioCodecType codec, int sample_rate, int channels, size_t count,
+                                          const AudioOutputFormat& output_format)
+{
+    if (AudioCodecType::kAAC == codec)
+    {
+        return aac_decoders_.Prewarm({codec, sample_rate, channels, 0, output_format}, count);
+    }
+
+    return mp3_decoders_.Prewarm({codec, 0, 0, 0, output_format}, count);
+}
@@ -0,0 +1,412 @@
+#include <audio_input_converter.h>
+
+#include <stdexcept>
+#include <algorithm>
+
+extern "C"
+{
+#include <libavutil/opt.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/mathematics.h>
+}
+
+AudioInputConverter::AudioInputConverter(const AudioInputFormat& format, int channels, int sample_rate,
+                                         AVSampleFormat target)
+    : format_(format)
+    , channels_(channels)
+    , sample_rate_(sample_rate)
+    , target_(target)
+    , bytes_per_sample_(0)
+    , native_(false)
+    , allocated_(false)
+    , swr_ctx_(nullptr)
+    , output_samples_(kChunkSamples)
+{
+    if (AV_SAMPLE_FMT_FLTP != target_ && AV_SAMPLE_FMT_S16P != target_)
+    {
+        throw std::runtime_error("Unsupported encoder sample format");
+    }
+
+    switch (format_.format)
+    {
+    case AudioInputSampleFormat::kS16:
+        bytes_per_sample_ = sizeof(int16_t);
+        break;
+    case AudioInputSampleFormat::kS24In32:
+        bytes_per_sample_ = sizeof(int32_t);
+        break;
+    default:
+        bytes_per_sample_ = sizeof(float);
+        break;
+    }
+
+    if (0 == format_.sample_rate)
+    {
+        format_.sample_rate = sample_rate_;
+    }
+
+    input_planes_.resize(channels_, nullptr);
+
+    // 原生格式直接写入 FIFO，不需要转换缓冲区
+    native_ = format_.sample_rate == sample_rate_ && AudioInputSampleFormat::kPlanarFloat == format_.format
+              && AV_SAMPLE_FMT_FLTP == target_;
+
+    if (format_.sample_rate != sample_rate_)
+    {
+        // 输出容量按采样率之比放大，并为滤波器延迟留出余量；超出部分由重采样器缓存到下次输出
+        output_samples_ =
+            static_cast<int>(av_rescale_rnd(kChunkSamples, sample_rate_, format_.sample_rate, AV_ROUND_UP)) + 256;
+    }
+}
+
+AudioInputConverter::~AudioInputConverter()
+{
+    Release();
+}
+
+bool AudioInputConverter::Allocate()
+{
+    if (allocated_ || native_)
+    {
+        return true;
+    }
+
+    if (format_.sample_rate != sample_rate_)
+    {
+        if (!ConfigureResampler())
+        {
+            return false;
+        }
+
+        // 平面浮点输入直接交给重采样器，其余格式先转换到暂存缓冲区
+        if (AudioInputSampleFormat::kPlanarFloat != format_.format)
+        {
+            stage_planes_.resize(channels_, nullptr);
+            if (av_samples_alloc(stage_planes_.data(), nullptr, channels_, kChunkSamples, AV_SAMPLE_FMT_FLTP, 0) < 0)
+            {
+                std::cerr << "Could not allocate conversion buffer" << std::endl;
+                stage_planes_.clear();
+                Release();
+                return false;
+            }
+        }
+    }
+
+    output_planes_.resize(channels_, nullptr);
+    if (av_samples_alloc(output_planes_.data(), nullptr, channels_, output_samples_, target_, 0) < 0)
+    {
+        std::cerr << "Could not allocate conversion buffer" << std::endl;
+        output_planes_.clear();
+        Release();
+        return false;
+    }
+
+    allocated_ = true;
+
+    return true;
+}
+
+void AudioInputConverter::Release()
+{
+    if (swr_ctx_)
+    {
+        swr_free(&swr_ctx_);
+    }
+    if (!stage_planes_.empty())
+    {
+        av_freep(&stage_planes_[0]);
+        stage_planes_.clear();
+    }
+    if (!output_planes_.empty())
+    {
+        av_freep(&output_planes_[0]);
+        output_planes_.clear();
+    }
+
+    allocated_ = false;
+}
+
+size_t AudioInputConverter::MemoryUsage() const
+{
+    // 重采样器内部的滤波器表由 swresample 管理，大小不对外公开，不计入
+    size_t bytes = 0U;
+    if (!stage_planes_.empty())
+    {
+        bytes += av_samples_get_buffer_size(nullptr, channels_, kChunkSamples, AV_SAMPLE_FMT_FLTP, 0);
+    }
+    if (!output_planes_.empty())
+    {
+        bytes += av_samples_get_buffer_size(nullptr, channels_, output_samples_, target_, 0);
+    }
+    bytes += carry_.capacity();
+
+    return bytes;
+}
+
+bool AudioInputConverter::ConfigureResampler()
+{
+    int64_t layout = av_get_default_channel_layout(channels_);
+
+    swr_ctx_ = swr_alloc_set_opts(nullptr, layout, target_, sample_rate_, layout, AV_SAMPLE_FMT_FLTP,
+                                  format_.sample_rate, 0, nullptr);
+    if (!swr_ctx_)
+    {
+        std::cerr << "Could not allocate audio resampler" << std::endl;
+        return false;
+    }
+
+    // 默认档位使用 swresample 的默认参数(filter_size 32, phase_shift 10)
+    switch (format_.quality)
+    {
+    case AudioResampleQuality::kFast:
+        av_opt_set_int(swr_ctx_, "filter_size", 8, 0);
+        av_opt_set_int(swr_ctx_, "phase_shift", 6, 0);
+        av_opt_set_int(swr_ctx_, "linear_interp", 1, 0);
+        break;
+    case AudioResampleQuality::kHigh:
+        av_opt_set_int(swr_ctx_, "filter_size", 64, 0);
+        av_opt_set_int(swr_ctx_, "phase_shift", 12, 0);
+        break;
+    default:
+        break;
+    }
+
+    if (swr_init(swr_ctx_) < 0)
+    {
+        std::cerr << "Could not initialize audio resampler" << std::endl;
+        swr_free(&swr_ctx_);
+        return false;
+    }
+
+    return true;
+}
+
+int AudioInputConverter::SampleCount(size_t size) const
+{
+    return static_cast<int>(size / (static_cast<size_t>(bytes_per_sample_) * channels_));
+}
+
+bool AudioInputConverter::WriteCarry(const uint8_t*& data, size_t& size, AVAudioFifo* fifo)
+{
+    size_t frame_bytes = static_cast<size_t>(bytes_per_sample_) * channels_;
+
+    if (AudioInputSampleFormat::kPlanarFloat == format_.format)
+    {
+        if (0 != size % frame_bytes)
+        {
+            std::cerr << "Planar input size is not a whole number of sample frames" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    if (carry_.empty())
+    {
+        return true;
+    }
+
+    size_t needed = frame_bytes - carry_.size();
+    size_t used   = std::min(needed, size);
+    carry_.insert(carry_.end(), data, data + used);
+    data += used;
+    size -= used;
+
+    if (carry_.size() < frame_bytes)
+    {
+        return true;
+    }
+
+    // 补全的一个样本帧单独转换写入
+    bool written = Write(carry_.data(), 1, 0, 1, fifo);
+    carry_.clear();
+
+    return written;
+}
+
+void AudioInputConverter::SaveCarry(const uint8_t* data, size_t size)
+{
+    size_t frame_bytes = static_cast<size_t>(bytes_per_sample_) * channels_;
+    size_t remainder   = size % frame_bytes;
+
+    if (remainder > 0 && AudioInputSampleFormat::kPlanarFloat != format_.format)
+    {
+        carry_.assign(data + size - remainder, data + size);
+    }
+}
+
+bool AudioInputConverter::Write(const uint8_t* data, int total_samples, int offset, int samples, AVAudioFifo* fifo)
+{
+    if (samples > kChunkSamples)
+    {
+        std::cerr << "Too many samples for one conversion" << std::endl;
+        return false;
+    }
+
+    if (!Allocate())
+    {
+        return false;
+    }
+
+    // 平面输入的各声道依次连续存放，交错输入只有一个数据平面
+    if (AudioInputSampleFormat::kPlanarFloat == format_.format)
+    {
+        for (int ch = 0; ch < channels_; ++ch)
+        {
+            input_planes_[ch] =
+                data + (static_cast<size_t>(ch) * total_samples + offset) * static_cast<size_t>(bytes_per_sample_);
+        }
+    }
+    else
+    {
+        input_planes_[0] = data + static_cast<size_t>(offset) * bytes_per_sample_ * channels_;
+    }
+
+    void** output    = reinterpret_cast<void**>(output_planes_.data());
+    int    converted = samples;
+
+    if (swr_ctx_)
+    {
+        const uint8_t** source = input_planes_.data();
+        if (!stage_planes_.empty())
+        {
+            if (!ConvertToFloat(input_planes_.data(), samples))
+            {
+                return false;
+            }
+            source = const_cast<const uint8_t**>(stage_planes_.data());
+        }
+
+        converted = swr_convert(swr_ctx_, output_planes_.data(), output_samples_, source, samples);
+        if (converted < 0)
+        {
+            std::cerr << "Error in resampling" << std::endl;
+            return false;
+        }
+    }
+    else if (native_)
+    {
+        output = reinterpret_cast<void**>(const_cast<uint8_t**>(input_planes_.data()));
+    }
+    else if (!ConvertToTarget(input_planes_.data(), samples))
+    {
+        return false;
+    }
+
+    if (av_audio_fifo_write(fifo, output, converted) < converted)
+    {
+        std::cerr << "Could not write data to fifo" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool AudioInputConverter::Flush(AVAudioFifo* fifo)
+{
+    // 输入在样本帧中间结束，剩余字节无法组成样本
+    if (!carry_.empty())
+    {
+        std::cerr << "Discarding " << carry_.size() << " bytes of incomplete sample frame" << std::endl;
+        carry_.clear();
+    }
+
+    if (!swr_ctx_)
+    {
+        return true;
+    }
+
+    for (;;)
+    {
+        int converted = swr_convert(swr_ctx_, output_planes_.data(), output_samples_, nullptr, 0);
+        if (converted < 0)
+        {
+            std::cerr << "Error in resampling" << std::endl;
+            return false;
+        }
+        if (0 == converted)
+        {
+            return true;
+        }
+
+        if (av_audio_fifo_write(fifo, reinterpret_cast<void**>(output_planes_.data()), converted) < converted)
+        {
+            std::cerr << "Could not write data to fifo" << std::endl;
+            return false;
+        }
+    }
+}
+
+bool AudioInputConverter::Reset()
+{
+    carry_.clear();
+
+    // 重新初始化会丢弃重采样器中缓存的样本，保留已设置的参数
+    if (swr_ctx_ && swr_init(swr_ctx_) < 0)
+    {
+        std::cerr << "Could not reset audio resampler" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void AudioInputConverter::ReleaseBuffers()
+{
+    Release();
+    std::vector<uint8_t>().swap(carry_);
+}
+
+bool AudioInputConverter::ConvertToTarget(const uint8_t* const* input, int samples)
+{
+    if (AV_SAMPLE_FMT_FLTP == target_)
+    {
+        return ConvertToFloat(input, samples);
+    }
+
+    int16_t* const* dst = reinterpret_cast<int16_t* const*>(output_planes_.data());
+
+    switch (format_.format)
+    {
+    case AudioInputSampleFormat::kS16:
+        DeinterleaveS16(reinterpret_cast<const int16_t*>(input[0]), dst, channels_, samples);
+        break;
+    case AudioInputSampleFormat::kS24In32:
+        DeinterleaveS24ToS16(reinterpret_cast<const int32_t*>(input[0]), dst, channels_, samples);
+        break;
+    case AudioInputSampleFormat::kFloat:
+        DeinterleaveFloatToS16(reinterpret_cast<const float*>(input[0]), dst, channels_, samples);
+        break;
+    case AudioInputSampleFormat::kPlanarFloat:
+        for (int ch = 0; ch < channels_; ++ch)
+        {
+            ConvertFloatToS16(reinterpret_cast<const float*>(input[ch]), dst[ch], samples);
+        }
+        break;
+    }
+
+    return true;
+}
+
+bool AudioInputConverter::ConvertToFloat(const uint8_t* const* input, int samples)
+{
+    // 重采样时写入暂存缓冲区，否则直接写入目标缓冲区
+    float* const* dst = reinterpret_cast<float* const*>(swr_ctx_ ? stage_planes_.data() : output_planes_.data());
+
+    switch (format_.format)
+    {
+    case AudioInputSampleFormat::kS16:
+        DeinterleaveS16ToFloat(reinterpret_cast<const int16_t*>(input[0]), dst, channels_, samples);
+        break;
+    case AudioInputSampleFormat::kS24In32:
+        DeinterleaveS24ToFloat(reinterpret_cast<const int32_t*>(input[0]), dst, channels_, samples);
+        break;
+    case AudioInputSampleFormat::kFloat:
+        DeinterleaveFloat(reinterpret_cast<const float*>(input[0]), dst, channels_, samples);
+        break;
+    case AudioInputSampleFormat::kPlanarFloat:
+        std::cerr << "Planar float input needs no conversion" << std::endl;
+        return false;
+    }
+
+    return true;
+}
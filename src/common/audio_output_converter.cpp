@@ -0,0 +1,371 @@
+#include <audio_output_converter.h>
+
+extern "C"
+{
+#include <libavutil/opt.h>
+}
+
+AudioOutputConverter::AudioOutputConverter(const AudioOutputFormat& format)
+    : format_(format)
+    , swr_ctx_(nullptr)
+    , swr_in_rate_(0)
+    , swr_in_channels_(0)
+    , swr_in_format_(AV_SAMPLE_FMT_NONE)
+{
+    InitDitherState(dither_, 0x2545F491U);
+}
+
+AudioOutputConverter::~AudioOutputConverter()
+{
+    if (swr_ctx_)
+    {
+        swr_free(&swr_ctx_);
+    }
+}
+
+bool AudioOutputConverter::Convert(const AVFrame* frame, AudioFrameView& view)
+{
+    AVSampleFormat format   = static_cast<AVSampleFormat>(frame->format);
+    int            channels = frame->channels;
+    int            samples  = frame->nb_samples;
+
+    view.channels    = channels;
+    view.nb_samples  = samples;
+    view.sample_rate = frame->sample_rate;
+    view.layout      = format_.layout;
+
+    // 测量解码器原生的样本(重采样之前)
+    Measure(frame);
+
+    if (format_.sample_rate > 0 && format_.sample_rate != frame->sample_rate)
+    {
+        return ConvertWithResampler(frame, view);
+    }
+
+    if (AV_SAMPLE_FMT_FLTP == format)
+    {
+        const float* const* src = reinterpret_cast<const float* const*>(frame->extended_data);
+
+        switch (format_.layout)
+        {
+        case AudioSampleLayout::kPlanarFloat:
+            // 与解码器原生格式一致，直接引用帧数据
+            view.data       = frame->extended_data;
+            view.planes     = channels;
+            view.plane_size = sizeof(float) * samples;
+            return true;
+        case AudioSampleLayout::kInterleavedFloat:
+            view.plane_size = sizeof(float) * samples * channels;
+            planes_.assign(1, Reserve(view.plane_size));
+            InterleaveFloat(src, reinterpret_cast<float*>(planes_[0]), channels, samples);
+            break;
+        case AudioSampleLayout::kInterleavedS16:
+            view.plane_size = sizeof(int16_t) * samples * channels;
+            planes_.assign(1, Reserve(view.plane_size));
+            InterleaveFloatToS16(src, reinterpret_cast<int16_t*>(planes_[0]), channels, samples,
+                                 format_.dither ? &dither_ : nullptr);
+            break;
+        }
+
+        view.data   = planes_.data();
+        view.planes = 1;
+        return true;
+    }
+
+    if (AV_SAMPLE_FMT_FLT == format && AudioSampleLayout::kInterleavedFloat == format_.layout)
+    {
+        // 已是交错浮点格式，直接引用帧数据
+        view.data       = frame->extended_data;
+        view.planes     = 1;
+        view.plane_size = sizeof(float) * samples * channels;
+        return true;
+    }
+
+    return ConvertWithResampler(frame, view);
+}
+
+bool AudioOutputConverter::Reset()
+{
+    if (meter_)
+    {
+        meter_->Reset();
+    }
+
+    if (!swr_ctx_)
+    {
+        return true;
+    }
+
+    // 重新初始化会清空内部的延迟样本，参数保持不变
+    if (swr_init(swr_ctx_) < 0)
+    {
+        std::cerr << "Could not reinitialize audio resampler" << std::endl;
+        ReleaseBuffers();
+        return false;
+    }
+
+    return true;
+}
+
+void AudioOutputConverter::ReleaseBuffers()
+{
+    // 重采样器连同其中的延迟样本一起释放，下一帧按需重新创建
+    if (swr_ctx_)
+    {
+        swr_free(&swr_ctx_);
+        swr_in_rate_     = 0;
+        swr_in_channels_ = 0;
+        swr_in_format_   = AV_SAMPLE_FMT_NONE;
+    }
+
+    std::vector<uint8_t>().swap(buffer_);
+    std::vector<uint8_t*>().swap(planes_);
+    std::vector<float>().swap(meter_samples_);
+    std::vector<const float*>().swap(meter_planes_);
+}
+
+size_t AudioOutputConverter::MemoryUsage() const
+{
+    // 重采样器内部的滤波器表由 swresample 管理，大小不对外公开，不计入
+    size_t bytes = buffer_.capacity() + planes_.capacity() * sizeof(uint8_t*)
+                   + meter_samples_.capacity() * sizeof(float) + meter_planes_.capacity() * sizeof(const float*);
+    if (meter_)
+    {
+        bytes += meter_->MemoryUsage();
+    }
+
+    return bytes;
+}
+
+bool AudioOutputConverter::EnableLoudness(bool enable, AVSampleFormat native_format)
+{
+    if (!enable)
+    {
+        meter_.reset();
+        return true;
+    }
+
+    if (AV_SAMPLE_FMT_FLTP != native_format && AV_SAMPLE_FMT_S16P != native_format)
+    {
+        std::cerr << "Loudness metering does not support sample format " << av_get_sample_fmt_name(native_format)
+                  << std::endl;
+        return false;
+    }
+
+    if (!meter_)
+    {
+        meter_.reset(new LoudnessMeter());
+    }
+
+    return true;
+}
+
+void AudioOutputConverter::Measure(const AVFrame* frame)
+{
+    if (!meter_)
+    {
+        return;
+    }
+
+    AVSampleFormat format   = static_cast<AVSampleFormat>(frame->format);
+    int            channels = frame->channels;
+    int            samples  = frame->nb_samples;
+
+    if (AV_SAMPLE_FMT_FLTP == format)
+    {
+        meter_->Process(reinterpret_cast<const float* const*>(frame->extended_data), channels, samples,
+                        frame->sample_rate);
+        return;
+    }
+
+    if (AV_SAMPLE_FMT_S16P != format)
+    {
+        return;
+    }
+
+    // 平面 16 位整数逐声道转换为浮点后测量，缓冲区只增不减并在帧间复用
+    size_t total = static_cast<size_t>(channels) * samples;
+    if (meter_samples_.size() < total)
+    {
+        meter_samples_.resize(total);
+    }
+    meter_planes_.resize(channels);
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        float* plane = meter_samples_.data() + static_cast<size_t>(ch) * samples;
+        DeinterleaveS16ToFloat(reinterpret_cast<const int16_t*>(frame->extended_data[ch]), &plane, 1, samples);
+        meter_planes_[ch] = plane;
+    }
+
+    meter_->Process(meter_planes_.data(), channels, samples, frame->sample_rate);
+}
+
+const LoudnessMeter* AudioOutputConverter::Loudness() const
+{
+    return meter_.get();
+}
+
+bool AudioOutputConverter::ConvertWithResampler(const AVFrame* frame, AudioFrameView& view)
+{
+    if (!ConfigureResampler(frame))
+    {
+        return false;
+    }
+
+    AVSampleFormat target      = TargetSampleFormat();
+    bool           planar      = AudioSampleLayout::kPlanarFloat == format_.layout;
+    int            channels    = frame->channels;
+    int            out_samples = swr_get_out_samples(swr_ctx_, frame->nb_samples);
+
+    PrepareResamplerOutput(out_samples, channels);
+
+    int converted = swr_convert(swr_ctx_, planes_.data(), out_samples,
+                                const_cast<const uint8_t**>(frame->extended_data), frame->nb_samples);
+    if (converted < 0)
+    {
+        std::cerr << "Error in resampling" << std::endl;
+        return false;
+    }
+
+    view.data        = planes_.data();
+    view.planes      = static_cast<int>(planes_.size());
+    view.nb_samples  = converted;
+    view.sample_rate = format_.sample_rate > 0 ? format_.sample_rate : frame->sample_rate;
+    view.plane_size  = static_cast<size_t>(converted) * av_get_bytes_per_sample(target) * (planar ? 1 : channels);
+
+    return true;
+}
+
+bool AudioOutputConverter::Flush(AudioFrameView& view)
+{
+    view.data        = nullptr;
+    view.planes      = 0;
+    view.plane_size  = 0;
+    view.nb_samples  = 0;
+    view.channels    = swr_in_channels_;
+    view.sample_rate = format_.sample_rate > 0 ? format_.sample_rate : swr_in_rate_;
+    view.layout      = format_.layout;
+
+    if (!swr_ctx_)
+    {
+        return true;
+    }
+
+    int out_samples = swr_get_out_samples(swr_ctx_, 0);
+    if (out_samples <= 0)
+    {
+        return true;
+    }
+
+    AVSampleFormat target   = TargetSampleFormat();
+    bool           planar   = AudioSampleLayout::kPlanarFloat == format_.layout;
+    int            channels = swr_in_channels_;
+
+    PrepareResamplerOutput(out_samples, channels);
+
+    // 空输入使重采样器输出滤波器中剩余的样本，之后可继续用于新的输入
+    int converted = swr_convert(swr_ctx_, planes_.data(), out_samples, nullptr, 0);
+    if (converted < 0)
+    {
+        std::cerr << "Error in flushing the resampler" << std::endl;
+        return false;
+    }
+
+    view.data       = planes_.data();
+    view.planes     = static_cast<int>(planes_.size());
+    view.nb_samples = converted;
+    view.plane_size = static_cast<size_t>(converted) * av_get_bytes_per_sample(target) * (planar ? 1 : channels);
+
+    return true;
+}
+
+bool AudioOutputConverter::ResamplerChanges(const AVFrame* frame) const
+{
+    return swr_ctx_
+           && (swr_in_rate_ != frame->sample_rate || swr_in_channels_ != frame->channels
+               || swr_in_format_ != static_cast<AVSampleFormat>(frame->format));
+}
+
+void AudioOutputConverter::PrepareResamplerOutput(int out_samples, int channels)
+{
+    AVSampleFormat target     = TargetSampleFormat();
+    bool           planar     = AudioSampleLayout::kPlanarFloat == format_.layout;
+    size_t         plane_size = static_cast<size_t>(out_samples) * av_get_bytes_per_sample(target) * (planar ? 1 : channels);
+    uint8_t*       buffer     = Reserve(plane_size * (planar ? channels : 1));
+
+    planes_.resize(planar ? channels : 1);
+    for (size_t i = 0; i < planes_.size(); ++i)
+    {
+        planes_[i] = buffer + i * plane_size;
+    }
+}
+
+bool AudioOutputConverter::ConfigureResampler(const AVFrame* frame)
+{
+    AVSampleFormat format = static_cast<AVSampleFormat>(frame->format);
+
+    // 码流参数(采样率、声道数、格式)不变时复用已有的重采样器
+    if (swr_ctx_ && !ResamplerChanges(frame))
+    {
+        return true;
+    }
+
+    // 旧重采样器中未取出的延迟样本随之丢弃，调用方需要时已先行 Flush
+    if (swr_ctx_)
+    {
+        swr_free(&swr_ctx_);
+    }
+
+    int64_t layout   = frame->channel_layout ? frame->channel_layout : av_get_default_channel_layout(frame->channels);
+    int     out_rate = format_.sample_rate > 0 ? format_.sample_rate : frame->sample_rate;
+
+    swr_ctx_ = swr_alloc_set_opts(nullptr, layout, TargetSampleFormat(), out_rate, layout, format, frame->sample_rate,
+                                  0, nullptr);
+    if (!swr_ctx_)
+    {
+        std::cerr << "Could not allocate audio resampler" << std::endl;
+        return false;
+    }
+
+    if (AudioSampleLayout::kInterleavedS16 == format_.layout && format_.dither)
+    {
+        av_opt_set_int(swr_ctx_, "dither_method", SWR_DITHER_TRIANGULAR, 0);
+    }
+
+    if (swr_init(swr_ctx_) < 0)
+    {
+        std::cerr << "Could not initialize audio resampler" << std::endl;
+        swr_free(&swr_ctx_);
+        return false;
+    }
+
+    swr_in_rate_     = frame->sample_rate;
+    swr_in_channels_ = frame->channels;
+    swr_in_format_   = format;
+
+    return true;
+}
+
+uint8_t* AudioOutputConverter::Reserve(size_t size)
+{
+    if (buffer_.size() < size)
+    {
+        buffer_.resize(size);
+    }
+
+    return buffer_.data();
+}
+
+AVSampleFormat AudioOutputConverter::TargetSampleFormat() const
+{
+    switch (format_.layout)
+    {
+    case AudioSampleLayout::kPlanarFloat:
+        return AV_SAMPLE_FMT_FLTP;
+    case AudioSampleLayout::kInterleavedS16:
+        return AV_SAMPLE_FMT_S16;
+    default:
+        return AV_SAMPLE_FMT_FLT;
+    }
+}
@@ -0,0 +1,203 @@
+#include <buffer_pool.h>
+
+#include <cstring>
+#include <map>
+#include <mutex>
+
+extern "C"
+{
+#include <libavutil/samplefmt.h>
+}
+
+size_t SharedBufferPool::PoolSize(size_t size)
+{
+    size_t pool_size = kMinPoolSize;
+    while (pool_size < size)
+    {
+        pool_size <<= 1;
+    }
+
+    return pool_size;
+}
+
+std::shared_ptr<AVBufferPool> SharedBufferPool::Acquire(size_t size)
+{
+    static std::mutex                                       mutex;
+    static std::map<size_t, std::weak_ptr<AVBufferPool>> pools;
+
+    size_t                      pool_size = PoolSize(size);
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::shared_ptr<AVBufferPool> pool = pools[pool_size].lock();
+    if (pool)
+    {
+        return pool;
+    }
+
+    AVBufferPool* raw = av_buffer_pool_init(pool_size, nullptr);
+    if (!raw)
+    {
+        std::cerr << "Could not allocate buffer pool" << std::endl;
+        return nullptr;
+    }
+
+    // 池中的缓冲区可能在最后一个使用者释放后才归还，av_buffer_pool_uninit 会等到全部归还后再释放
+    pool = std::shared_ptr<AVBufferPool>(raw, [](AVBufferPool* released) { av_buffer_pool_uninit(&released); });
+    pools[pool_size] = pool;
+
+    return pool;
+}
+
+PacketBufferPool::PacketBufferPool()
+    : pool_(nullptr)
+    , pool_size_(0U)
+{
+}
+
+PacketBufferPool::~PacketBufferPool()
+{
+}
+
+bool PacketBufferPool::InstallEncodeBuffer(AVCodecContext* codec_context)
+{
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(58, 134, 100)
+    if (!(codec_context->codec->capabilities & AV_CODEC_CAP_DR1))
+    {
+        return false;
+    }
+
+    codec_context->opaque            = this;
+    codec_context->get_encode_buffer = &PacketBufferPool::GetEncodeBuffer;
+
+    return true;
+#else
+    (void)codec_context;
+    return false;
+#endif
+}
+
+bool PacketBufferPool::Fill(AVPacket* packet, const uint8_t* data, size_t size)
+{
+    av_packet_unref(packet);
+
+    packet->buf = Get(size);
+    if (!packet->buf)
+    {
+        return false;
+    }
+
+    memcpy(packet->buf->data, data, size);
+    packet->data = packet->buf->data;
+    packet->size = static_cast<int>(size);
+
+    return true;
+}
+
+AVBufferRef* PacketBufferPool::Get(size_t size)
+{
+    // 当前池容量不足时换到更大的等级，之后同等大小的包都从新池中取
+    size_t required = size + AV_INPUT_BUFFER_PADDING_SIZE;
+    if (!pool_ || pool_size_ < required)
+    {
+        pool_ = SharedBufferPool::Acquire(required);
+        if (!pool_)
+        {
+            pool_size_ = 0U;
+            return nullptr;
+        }
+        pool_size_ = SharedBufferPool::PoolSize(required);
+    }
+
+    AVBufferRef* buf = av_buffer_pool_get(pool_.get());
+    if (!buf)
+    {
+        std::cerr << "Could not get buffer from pool" << std::endl;
+        return nullptr;
+    }
+    memset(buf->data + size, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+
+    return buf;
+}
+
+int PacketBufferPool::GetEncodeBuffer(AVCodecContext* codec_context, AVPacket* packet, int flags)
+{
+    (void)flags;
+
+    // packet->size 已由编码器设置为所需的负载长度
+    PacketBufferPool* self = static_cast<PacketBufferPool*>(codec_context->opaque);
+
+    packet->buf = self->Get(packet->size);
+    if (!packet->buf)
+    {
+        return AVERROR(ENOMEM);
+    }
+    packet->data = packet->buf->data;
+
+    return 0;
+}
+
+AudioFramePool::AudioFramePool(AVSampleFormat format, int channels, int nb_samples)
+    : pool_(nullptr)
+    , planes_(av_sample_fmt_is_planar(format) ? channels : 1)
+    , linesize_(0)
+{
+    if (planes_ > AV_NUM_DATA_POINTERS)
+    {
+        throw std::runtime_error("Too many channels for pooled audio frame");
+    }
+
+    if (av_samples_get_buffer_size(&linesize_, channels, nb_samples, format, 0) < 0)
+    {
+        throw std::runtime_error("Invalid audio frame parameters");
+    }
+
+    pool_ = SharedBufferPool::Acquire(linesize_);
+    if (!pool_)
+    {
+        throw std::runtime_error("Could not allocate audio frame pool");
+    }
+}
+
+AudioFramePool::~AudioFramePool()
+{
+}
+
+bool AudioFramePool::GetBuffer(AVFrame* frame)
+{
+    // 没有缓冲区时 av_frame_is_writable 返回 0
+    if (av_frame_is_writable(frame))
+    {
+        return true;
+    }
+
+    ReleaseBuffer(frame);
+
+    for (int i = 0; i < planes_; ++i)
+    {
+        frame->buf[i] = av_buffer_pool_get(pool_.get());
+        if (!frame->buf[i])
+        {
+            std::cerr << "Could not get audio frame buffer from pool" << std::endl;
+            return false;
+        }
+        frame->data[i] = frame->buf[i]->data;
+    }
+    frame->extended_data = frame->data;
+    frame->linesize[0]   = linesize_;
+
+    return true;
+}
+
+void AudioFramePool::ReleaseBuffer(AVFrame* frame) const
+{
+    for (int i = 0; i < AV_NUM_DATA_POINTERS; ++i)
+    {
+        av_buffer_unref(&frame->buf[i]);
+        frame->data[i] = nullptr;
+    }
+}
+
+size_t AudioFramePool::BufferSize(const AVFrame* frame) const
+{
+    return frame->buf[0] ? static_cast<size_t>(planes_) * linesize_ : 0U;
+}
@@ -0,0 +1,19 @@
+#include <codec_log.h>
+
+#include <string>
+
+void LogSupportedSampleFormats(const AVCodec* codec, const char* name)
+{
+    if (!codec || av_log_get_level() < AV_LOG_VERBOSE)
+    {
+        return;
+    }
+
+    std::string formats;
+    for (const enum AVSampleFormat* p = codec->sample_fmts; p && *p != AV_SAMPLE_FMT_NONE; ++p)
+    {
+        formats += av_get_sample_fmt_name(*p);
+        formats += " ";
+    }
+    av_log(nullptr, AV_LOG_VERBOSE, "%s Supported sample formats: %s\n", name, formats.c_str());
+}
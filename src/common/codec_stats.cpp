@@ -0,0 +1,175 @@
+#include <codec_stats.h>
+
+#include <cmath>
+#include <thread>
+
+namespace
+{
+// TSC 频率只在第一次读取快照时标定一次，编解码路径上不涉及换算
+double NanosecondsPerTick()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    static const double ns_per_tick = []() {
+        std::chrono::steady_clock::time_point start_time  = std::chrono::steady_clock::now();
+        uint64_t                              start_ticks = CodecStats::ReadTicks();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        uint64_t                              end_ticks = CodecStats::ReadTicks();
+        std::chrono::steady_clock::time_point end_time  = std::chrono::steady_clock::now();
+
+        double ns = std::chrono::duration<double, std::nano>(end_time - start_time).count();
+        return end_ticks > start_ticks ? ns / static_cast<double>(end_ticks - start_ticks) : 1.0;
+    }();
+
+    return ns_per_tick;
+#else
+    return 1.0;
+#endif
+}
+} // namespace
+
+const char* CodecStageName(CodecStage stage)
+{
+    switch (stage)
+    {
+    case CodecStage::kConvert:
+        return "convert";
+    case CodecStage::kSend:
+        return "send";
+    case CodecStage::kReceive:
+        return "receive";
+    case CodecStage::kCallback:
+        return "callback";
+    case CodecStage::kCount:
+        break;
+    }
+
+    return "unknown";
+}
+
+double CodecStatsSnapshot::TotalNanoseconds(CodecStage stage) const
+{
+    return static_cast<double>(stages[static_cast<int>(stage)].total_ticks) * ns_per_tick;
+}
+
+double CodecStatsSnapshot::MeanNanoseconds(CodecStage stage) const
+{
+    const CodecStageSnapshot& snapshot = stages[static_cast<int>(stage)];
+    return snapshot.count > 0 ? TotalNanoseconds(stage) / static_cast<double>(snapshot.count) : 0.0;
+}
+
+double CodecStatsSnapshot::MaxNanoseconds(CodecStage stage) const
+{
+    return static_cast<double>(stages[static_cast<int>(stage)].max_ticks) * ns_per_tick;
+}
+
+double CodecStatsSnapshot::PercentileNanoseconds(CodecStage stage, double ratio) const
+{
+    const CodecStageSnapshot& snapshot = stages[static_cast<int>(stage)];
+    if (0 == snapshot.count)
+    {
+        return 0.0;
+    }
+
+    // 找到累计次数达到目标的桶，取桶区间的几何中点
+    uint64_t target     = static_cast<uint64_t>(std::ceil(ratio * static_cast<double>(snapshot.count)));
+    uint64_t cumulative = 0;
+    for (int i = 0; i < kCodecStatsBuckets; ++i)
+    {
+        cumulative += snapshot.buckets[i];
+        if (cumulative >= target && snapshot.buckets[i] > 0)
+        {
+            return std::ldexp(std::sqrt(2.0), i) * ns_per_tick;
+        }
+    }
+
+    return MaxNanoseconds(stage);
+}
+
+CodecStats::CodecStats()
+{
+    Reset();
+}
+
+void CodecStats::Snapshot(CodecStatsSnapshot& snapshot) const
+{
+    snapshot.frames_in   = frames_in_.load(std::memory_order_relaxed);
+    snapshot.frames_out  = frames_out_.load(std::memory_order_relaxed);
+    snapshot.bytes_in    = bytes_in_.load(std::memory_order_relaxed);
+    snapshot.bytes_out   = bytes_out_.load(std::memory_order_relaxed);
+    snapshot.errors      = errors_.load(std::memory_order_relaxed);
+    snapshot.ns_per_tick = NanosecondsPerTick();
+
+    for (int stage = 0; stage < kCodecStageCount; ++stage)
+    {
+        const StageHistogram& histogram = stages_[stage];
+        CodecStageSnapshot&   target    = snapshot.stages[stage];
+
+        target.count       = histogram.count.load(std::memory_order_relaxed);
+        target.total_ticks = histogram.total_ticks.load(std::memory_order_relaxed);
+        target.max_ticks   = histogram.max_ticks.load(std::memory_order_relaxed);
+        for (int i = 0; i < kCodecStatsBuckets; ++i)
+        {
+            target.buckets[i] = histogram.buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void CodecStats::Reset()
+{
+    frames_in_.store(0, std::memory_order_relaxed);
+    frames_out_.store(0, std::memory_order_relaxed);
+    bytes_in_.store(0, std::memory_order_relaxed);
+    bytes_out_.store(0, std::memory_order_relaxed);
+    errors_.store(0, std::memory_order_relaxed);
+
+    for (StageHistogram& histogram : stages_)
+    {
+        histogram.count.store(0, std::memory_order_relaxed);
+        histogram.total_ticks.store(0, std::memory_order_relaxed);
+        histogram.max_ticks.store(0, std::memory_order_relaxed);
+        for (std::atomic<uint64_t>& bucket : histogram.buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void CodecStatsHolder::Enable(bool enable)
+{
+    if (enable && !stats_)
+    {
+        stats_.reset(new CodecStats());
+    }
+    else if (!enable)
+    {
+        stats_.reset();
+    }
+}
+
+bool CodecStatsHolder::Snapshot(CodecStatsSnapshot& snapshot) const
+{
+    if (!stats_)
+    {
+        return false;
+    }
+
+    stats_->Snapshot(snapshot);
+
+    return true;
+}
+
+void CodecStatsHolder::Reset()
+{
+    if (stats_)
+    {
+        stats_->Reset();
+    }
+}
+
+void CodecStatsHolder::RecordError()
+{
+    if (stats_)
+    {
+        stats_->AddError();
+    }
+}
@@ -0,0 +1,175 @@
+#include <encoded_packet.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+EncodedPacket::EncodedPacket()
+    : buf_(nullptr)
+    , data_(nullptr)
+    , size_(0U)
+    , pts_(AV_NOPTS_VALUE)
+    , duration_(0)
+    , header_()
+    , header_size_(0U)
+{
+}
+
+EncodedPacket::EncodedPacket(AVPacket* packet)
+    : buf_(nullptr)
+    , data_(nullptr)
+    , size_(0U)
+    , pts_(AV_NOPTS_VALUE)
+    , duration_(0)
+    , header_()
+    , header_size_(0U)
+{
+    // 编码器输出的包总是引用计数的，非引用计数的包才需要拷贝一次
+    if (!packet->buf && packet->size > 0 && av_packet_make_refcounted(packet) < 0)
+    {
+        av_packet_unref(packet);
+        return;
+    }
+
+    // 直接取走缓冲区引用，packet 中剩余的字段(含边信息)随后清空
+    buf_         = packet->buf;
+    data_        = packet->data;
+    size_        = static_cast<size_t>(packet->size);
+    pts_         = packet->pts;
+    duration_    = packet->duration;
+    packet->buf  = nullptr;
+    packet->data = nullptr;
+    packet->size = 0;
+    av_packet_unref(packet);
+}
+
+EncodedPacket::~EncodedPacket()
+{
+    Release();
+}
+
+EncodedPacket::EncodedPacket(EncodedPacket&& other) noexcept
+    : buf_(other.buf_)
+    , data_(other.data_)
+    , size_(other.size_)
+    , pts_(other.pts_)
+    , duration_(other.duration_)
+    , header_size_(other.header_size_)
+{
+    memcpy(header_, other.header_, sizeof(header_));
+    other.buf_         = nullptr;
+    other.data_        = nullptr;
+    other.size_        = 0U;
+    other.header_size_ = 0U;
+}
+
+EncodedPacket& EncodedPacket::operator=(EncodedPacket&& other) noexcept
+{
+    if (this != &other)
+    {
+        Release();
+        buf_         = other.buf_;
+        data_        = other.data_;
+        size_        = other.size_;
+        pts_         = other.pts_;
+        duration_    = other.duration_;
+        header_size_ = other.header_size_;
+        memcpy(header_, other.header_, sizeof(header_));
+        other.buf_         = nullptr;
+        other.data_        = nullptr;
+        other.size_        = 0U;
+        other.header_size_ = 0U;
+    }
+
+    return *this;
+}
+
+void EncodedPacket::Release()
+{
+    av_buffer_unref(&buf_);
+    data_ = nullptr;
+    size_ = 0U;
+}
+
+EncodedPacket EncodedPacket::Ref() const
+{
+    EncodedPacket packet;
+
+    if (buf_)
+    {
+        packet.buf_ = av_buffer_ref(buf_);
+        if (packet.buf_)
+        {
+            packet.data_ = data_;
+            packet.size_ = size_;
+        }
+    }
+    packet.pts_      = pts_;
+    packet.duration_ = duration_;
+    packet.SetHeader(header_, header_size_);
+
+    return packet;
+}
+
+bool EncodedPacket::Empty() const
+{
+    return 0U == size_;
+}
+
+const uint8_t* EncodedPacket::Data() const
+{
+    return data_;
+}
+
+size_t EncodedPacket::Size() const
+{
+    return size_;
+}
+
+int64_t EncodedPacket::Pts() const
+{
+    return pts_;
+}
+
+int64_t EncodedPacket::Duration() const
+{
+    return duration_;
+}
+
+const uint8_t* EncodedPacket::Header() const
+{
+    return header_;
+}
+
+size_t EncodedPacket::HeaderSize() const
+{
+    return header_size_;
+}
+
+void EncodedPacket::SetHeader(const uint8_t* header, size_t size)
+{
+    header_size_ = static_cast<uint8_t>(std::min(size, kMaxHeaderSize));
+    memcpy(header_, header, header_size_);
+}
+
+int EncodedPacket::FillIovec(struct iovec* iov) const
+{
+    int count = 0;
+
+    if (header_size_ > 0)
+    {
+        iov[count++] = {const_cast<uint8_t*>(header_), header_size_};
+    }
+
+    if (size_ > 0)
+    {
+        iov[count++] = {const_cast<uint8_t*>(data_), size_};
+    }
+
+    return count;
+}
+
+AVBufferRef* EncodedPacket::Buffer() const
+{
+    return buf_;
+}
@@ -0,0 +1,337 @@
+#include <loudness_meter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+const double kNegativeInfinity = -std::numeric_limits<double>::infinity();
+const double kAbsoluteGate     = -70.0; // LUFS
+const double kRelativeGate     = -10.0; // LU
+const double kHistogramStep    = 0.1;   // 直方图覆盖 [-70, 30) LUFS
+
+double EnergyToLoudness(double energy)
+{
+    return energy > 0.0 ? -0.691 + 10.0 * std::log10(energy) : kNegativeInfinity;
+}
+
+// BS.1770 中的声道权重，按 FFmpeg 默认声道顺序(L R C LFE Ls Rs)
+double ChannelWeight(int channel, int channels)
+{
+    if (6 == channels)
+    {
+        return (3 == channel) ? 0.0 : ((channel >= 4) ? 1.41 : 1.0);
+    }
+    if (5 == channels)
+    {
+        return (channel >= 3) ? 1.41 : 1.0;
+    }
+    return 1.0;
+}
+} // namespace
+
+LoudnessMeter::LoudnessMeter()
+    : channels_(0)
+    , sample_rate_(0)
+    , block_samples_(0)
+    , block_filled_(0)
+    , shelf_()
+    , highpass_()
+    , block_count_(0U)
+    , histogram_(kHistogramBins)
+    , momentary_(kNegativeInfinity)
+    , short_term_(kNegativeInfinity)
+    , max_momentary_(kNegativeInfinity)
+    , max_short_term_(kNegativeInfinity)
+    , frame_sample_peak_(0.0F)
+    , frame_true_peak_(0.0F)
+    , sample_peak_(0.0F)
+    , true_peak_(0.0F)
+    , samples_(0U)
+{
+    // 多相插值滤波器：Hann 窗截断的 sinc，第 p 相输出位于输入样本之间 p/4 处，
+    // 延迟 kTruePeakTaps/2 个输入样本；每相系数归一化使直流增益为 1
+    for (int p = 0; p < kTruePeakFactor; ++p)
+    {
+        double sum = 0.0;
+        for (int m = 0; m < kTruePeakTaps; ++m)
+        {
+            double t      = m - kTruePeakTaps / 2 + static_cast<double>(p) / kTruePeakFactor;
+            double sinc   = (0.0 == t) ? 1.0 : std::sin(M_PI * t) / (M_PI * t);
+            double window = 0.5 + 0.5 * std::cos(M_PI * t / (kTruePeakTaps / 2 + 0.5));
+            coefficients_[p][m] = static_cast<float>(sinc * window);
+            sum += sinc * window;
+        }
+        for (int m = 0; m < kTruePeakTaps; ++m)
+        {
+            coefficients_[p][m] = static_cast<float>(coefficients_[p][m] / sum);
+        }
+    }
+
+    blocks_.fill(0.0);
+}
+
+void LoudnessMeter::Process(const float* const* planes, int channels, int nb_samples, int sample_rate)
+{
+    if (channels != channels_ || sample_rate != sample_rate_)
+    {
+        Configure(channels, sample_rate);
+    }
+
+    frame_sample_peak_ = 0.0F;
+    frame_true_peak_   = 0.0F;
+
+    // 子块边界可能落在帧内，按子块剩余样本数分段滤波
+    int offset = 0;
+    while (offset < nb_samples)
+    {
+        int count = std::min(nb_samples - offset, block_samples_ - block_filled_);
+        for (int ch = 0; ch < channels_; ++ch)
+        {
+            FilterChannel(states_[ch], planes[ch] + offset, count, frame_sample_peak_);
+        }
+
+        offset += count;
+        block_filled_ += count;
+        if (block_filled_ == block_samples_)
+        {
+            FinishBlock();
+        }
+    }
+
+    for (int ch = 0; ch < channels_; ++ch)
+    {
+        frame_true_peak_ = std::max(frame_true_peak_, TruePeak(states_[ch], planes[ch], nb_samples));
+    }
+
+    // 真峰值不低于样本峰值
+    frame_true_peak_ = std::max(frame_true_peak_, frame_sample_peak_);
+    sample_peak_     = std::max(sample_peak_, frame_sample_peak_);
+    true_peak_       = std::max(true_peak_, frame_true_peak_);
+    samples_ += static_cast<uint64_t>(nb_samples);
+}
+
+void LoudnessMeter::Reset()
+{
+    // 清空滤波器状态与全部结果，保留当前的码流参数
+    if (channels_ > 0)
+    {
+        Configure(channels_, sample_rate_);
+    }
+}
+
+void LoudnessMeter::Snapshot(LoudnessSnapshot& snapshot) const
+{
+    snapshot.momentary         = momentary_;
+    snapshot.short_term        = short_term_;
+    snapshot.frame_sample_peak = frame_sample_peak_;
+    snapshot.frame_true_peak   = frame_true_peak_;
+    snapshot.max_momentary     = max_momentary_;
+    snapshot.max_short_term    = max_short_term_;
+    snapshot.sample_peak       = sample_peak_;
+    snapshot.true_peak         = true_peak_;
+    snapshot.samples           = samples_;
+    snapshot.integrated        = kNegativeInfinity;
+
+    // 绝对门限以上的门限块平均能量减 10 LU 即为相对门限
+    uint64_t count  = 0U;
+    double   energy = 0.0;
+    for (const HistogramBin& bin : histogram_)
+    {
+        count += bin.count;
+        energy += bin.energy;
+    }
+    if (0U == count)
+    {
+        return;
+    }
+
+    double gate  = EnergyToLoudness(energy / count) + kRelativeGate;
+    int    first = static_cast<int>(std::ceil((gate - kAbsoluteGate) / kHistogramStep - 0.5));
+    count        = 0U;
+    energy       = 0.0;
+    for (int i = std::max(first, 0); i < kHistogramBins; ++i)
+    {
+        count += histogram_[i].count;
+        energy += histogram_[i].energy;
+    }
+
+    if (count > 0U)
+    {
+        snapshot.integrated = EnergyToLoudness(energy / count);
+    }
+}
+
+void LoudnessMeter::Configure(int channels, int sample_rate)
+{
+    channels_      = channels;
+    sample_rate_   = sample_rate;
+    block_samples_ = std::max(1, static_cast<int>(std::lround(sample_rate / 10.0)));
+    block_filled_  = 0;
+
+    // BS.1770 给出的是 48kHz 的系数，其他采样率由模拟原型的参数双线性变换得到
+    double k  = std::tan(M_PI * 1681.974450955533 / sample_rate);
+    double q  = 0.7071752369554196;
+    double vh = std::pow(10.0, 3.999843853973347 / 20.0);
+    double vb = std::pow(vh, 0.4996667741545416);
+    double a0 = 1.0 + k / q + k * k;
+    shelf_.b0 = (vh + vb * k / q + k * k) / a0;
+    shelf_.b1 = 2.0 * (k * k - vh) / a0;
+    shelf_.b2 = (vh - vb * k / q + k * k) / a0;
+    shelf_.a1 = 2.0 * (k * k - 1.0) / a0;
+    shelf_.a2 = (1.0 - k / q + k * k) / a0;
+
+    k            = std::tan(M_PI * 38.13547087602444 / sample_rate);
+    q            = 0.5003270373238773;
+    a0           = 1.0 + k / q + k * k;
+    highpass_.b0 = 1.0;
+    highpass_.b1 = -2.0;
+    highpass_.b2 = 1.0;
+    highpass_.a1 = 2.0 * (k * k - 1.0) / a0;
+    highpass_.a2 = (1.0 - k / q + k * k) / a0;
+
+    states_.assign(channels_, ChannelState{});
+    for (int ch = 0; ch < channels_; ++ch)
+    {
+        states_[ch].weight = ChannelWeight(ch, channels_);
+    }
+
+    blocks_.fill(0.0);
+    block_count_ = 0U;
+    std::fill(histogram_.begin(), histogram_.end(), HistogramBin{0U, 0.0});
+    momentary_         = kNegativeInfinity;
+    short_term_        = kNegativeInfinity;
+    max_momentary_     = kNegativeInfinity;
+    max_short_term_    = kNegativeInfinity;
+    frame_sample_peak_ = 0.0F;
+    frame_true_peak_   = 0.0F;
+    sample_peak_       = 0.0F;
+    true_peak_         = 0.0F;
+    samples_           = 0U;
+}
+
+void LoudnessMeter::FilterChannel(ChannelState& state, const float* src, int nb_samples, float& peak)
+{
+    // 直接 II 型转置结构，状态与累加使用双精度，避免长时间静音后的精度问题
+    const Biquad& s      = shelf_;
+    const Biquad& h      = highpass_;
+    double        s1     = state.z[0][0];
+    double        s2     = state.z[0][1];
+    double        h1     = state.z[1][0];
+    double        h2     = state.z[1][1];
+    double        energy = 0.0;
+    float         max    = peak;
+
+    for (int i = 0; i < nb_samples; ++i)
+    {
+        double x = src[i];
+        double y = s.b0 * x + s1;
+        s1       = s.b1 * x - s.a1 * y + s2;
+        s2       = s.b2 * x - s.a2 * y;
+
+        double z = h.b0 * y + h1;
+        h1       = h.b1 * y - h.a1 * z + h2;
+        h2       = h.b2 * y - h.a2 * z;
+
+        energy += z * z;
+        max = std::max(max, std::fabs(src[i]));
+    }
+
+    state.z[0][0] = s1;
+    state.z[0][1] = s2;
+    state.z[1][0] = h1;
+    state.z[1][1] = h2;
+    state.energy += energy;
+    peak = max;
+}
+
+float LoudnessMeter::TruePeak(ChannelState& state, const float* src, int nb_samples)
+{
+    const int history = kTruePeakTaps - 1;
+    size_t    size    = static_cast<size_t>(history + nb_samples);
+    if (scratch_.size() < size)
+    {
+        scratch_.resize(size);
+    }
+
+    // 前几帧的样本与本帧样本拼接为连续的输入
+    float* input = scratch_.data();
+    memcpy(input, state.history, sizeof(float) * history);
+    memcpy(input + history, src, sizeof(float) * nb_samples);
+
+    // 第 0 相即为输入样本本身，已计入样本峰值
+    float max = 0.0F;
+    for (int i = 0; i < nb_samples; ++i)
+    {
+        const float* x = input + i;
+        for (int p = 1; p < kTruePeakFactor; ++p)
+        {
+            const float* c   = coefficients_[p];
+            float        sum = 0.0F;
+            for (int m = 0; m < kTruePeakTaps; ++m)
+            {
+                sum += x[history - m] * c[m];
+            }
+            max = std::max(max, std::fabs(sum));
+        }
+    }
+
+    memcpy(state.history, input + nb_samples, sizeof(float) * history);
+
+    return max;
+}
+
+void LoudnessMeter::FinishBlock()
+{
+    double energy = 0.0;
+    for (ChannelState& state : states_)
+    {
+        energy += state.weight * state.energy / block_samples_;
+        state.energy = 0.0;
+    }
+
+    blocks_[block_count_ % kShortTermBlocks] = energy;
+    ++block_count_;
+    block_filled_ = 0;
+
+    if (block_count_ >= 4U)
+    {
+        // 最近 4 个子块即一个 400ms 门限块，相邻门限块重叠 75%
+        double block_energy = WindowEnergy(4);
+        momentary_          = EnergyToLoudness(block_energy);
+        max_momentary_      = std::max(max_momentary_, momentary_);
+
+        if (momentary_ >= kAbsoluteGate)
+        {
+            int bin = static_cast<int>((momentary_ - kAbsoluteGate) / kHistogramStep);
+            bin     = std::min(bin, kHistogramBins - 1);
+            histogram_[bin].count += 1U;
+            histogram_[bin].energy += block_energy;
+        }
+    }
+
+    if (block_count_ >= static_cast<uint64_t>(kShortTermBlocks))
+    {
+        short_term_     = EnergyToLoudness(WindowEnergy(kShortTermBlocks));
+        max_short_term_ = std::max(max_short_term_, short_term_);
+    }
+}
+
+double LoudnessMeter::WindowEnergy(int blocks) const
+{
+    double energy = 0.0;
+    for (int i = 1; i <= blocks; ++i)
+    {
+        energy += blocks_[(block_count_ - i) % kShortTermBlocks];
+    }
+
+    return energy / blocks;
+}
+
+size_t LoudnessMeter::MemoryUsage() const
+{
+    return sizeof(*this) + states_.capacity() * sizeof(ChannelState) + histogram_.capacity() * sizeof(HistogramBin)
+           + scratch_.capacity() * sizeof(float);
+}
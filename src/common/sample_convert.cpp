@@ -0,0 +1,890 @@
+#include <sample_convert.h>
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SAMPLE_CONVERT_X86 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+using InterleaveFloatFunc = void (*)(const float* const* src, float* dst, int channels, int nb_samples);
+using InterleaveS16Func   = void (*)(const float* const* src, int16_t* dst, int channels, int nb_samples,
+                                   DitherState* dither);
+template <typename In, typename Out>
+using DeinterleaveFunc = void (*)(const In* src, Out* const* dst, int channels, int nb_samples);
+using FloatToS16Func   = void (*)(const float* src, int16_t* dst, int nb_samples);
+template <typename In>
+using SumSquaresFunc = double (*)(const In* src, int nb_samples);
+
+struct SampleConvertKernels
+{
+    const char*                        name;
+    InterleaveFloatFunc                interleave_float;
+    InterleaveS16Func                  interleave_s16;
+    DeinterleaveFunc<int16_t, float>   deinterleave_s16_to_float;
+    DeinterleaveFunc<int32_t, float>   deinterleave_s24_to_float;
+    DeinterleaveFunc<float, float>     deinterleave_float;
+    DeinterleaveFunc<int16_t, int16_t> deinterleave_s16;
+    DeinterleaveFunc<int32_t, int16_t> deinterleave_s24_to_s16;
+    DeinterleaveFunc<float, int16_t>   deinterleave_float_to_s16;
+    FloatToS16Func                     float_to_s16;
+    SumSquaresFunc<float>              sum_squares_float;
+    SumSquaresFunc<int16_t>            sum_squares_s16;
+};
+
+inline uint32_t NextRandom(uint32_t& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// 取随机数高23位作为尾数构造[1, 2)内的浮点数
+inline float RandomUnit(uint32_t& state)
+{
+    uint32_t bits  = (NextRandom(state) >> 9) | 0x3F800000U;
+    float    value = 0.0F;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline int16_t FloatToS16(float sample, float noise)
+{
+    float value = sample * 32768.0F + noise;
+    if (value >= 32767.0F)
+    {
+        return 32767;
+    }
+    if (value <= -32768.0F)
+    {
+        return -32768;
+    }
+    return static_cast<int16_t>(lrintf(value));
+}
+
+void InterleaveS16Scalar(const float* const* src, int16_t* dst, int channels, int nb_samples, DitherState* dither)
+{
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        const float* in  = src[ch];
+        int16_t*     out = dst + ch;
+
+        for (int i = 0; i < nb_samples; ++i)
+        {
+            // 两个均匀分布之差为三角分布(TPDF)，幅度为±1 LSB
+            float noise       = dither ? RandomUnit(dither->state[0]) - RandomUnit(dither->state[0]) : 0.0F;
+            out[i * channels] = FloatToS16(in[i], noise);
+        }
+    }
+}
+
+// 通用N声道实现：逐声道写入跨步位置，每个声道只顺序读一遍源数据
+void InterleaveFloatGeneric(const float* const* src, float* dst, int channels, int nb_samples)
+{
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        const float* in  = src[ch];
+        float*       out = dst + ch;
+
+        for (int i = 0; i < nb_samples; ++i)
+        {
+            out[i * channels] = in[i];
+        }
+    }
+}
+
+void InterleaveFloatScalar(const float* const* src, float* dst, int channels, int nb_samples)
+{
+    if (1 == channels)
+    {
+        memcpy(dst, src[0], sizeof(float) * nb_samples);
+        return;
+    }
+
+    if (2 == channels)
+    {
+        const float* left  = src[0];
+        const float* right = src[1];
+
+        for (int i = 0; i < nb_samples; ++i)
+        {
+            dst[2 * i]     = left[i];
+            dst[2 * i + 1] = right[i];
+        }
+        return;
+    }
+
+    InterleaveFloatGeneric(src, dst, channels, nb_samples);
+}
+
+inline float S16SampleToFloat(int16_t sample)
+{
+    return sample * (1.0F / 32768.0F);
+}
+
+// 先左移 8 位丢弃容器的高 8 位，按 32 位满幅度归一化
+inline float S24SampleToFloat(int32_t sample)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(sample) << 8) * (1.0F / 2147483648.0F);
+}
+
+inline int16_t S24SampleToS16(int32_t sample)
+{
+    int32_t value = static_cast<int32_t>(static_cast<uint32_t>(sample) << 8) >> 8;
+    value         = (value + 128) >> 8;
+    return static_cast<int16_t>(value > 32767 ? 32767 : value);
+}
+
+inline float FloatSampleToFloat(float sample)
+{
+    return sample;
+}
+
+inline int16_t S16SampleToS16(int16_t sample)
+{
+    return sample;
+}
+
+inline int16_t FloatSampleToS16(float sample)
+{
+    return FloatToS16(sample, 0.0F);
+}
+
+// 处理 [begin, end) 范围内的样本帧，SIMD 实现用它处理尾部
+template <typename In, typename Out, Out (*Convert)(In)>
+void DeinterleaveRange(const In* src, Out* const* dst, int channels, int begin, int end)
+{
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        Out* out = dst[ch];
+
+        for (int i = begin; i < end; ++i)
+        {
+            out[i] = Convert(src[i * channels + ch]);
+        }
+    }
+}
+
+template <typename In, typename Out, Out (*Convert)(In)>
+void DeinterleaveScalar(const In* src, Out* const* dst, int channels, int nb_samples)
+{
+    DeinterleaveRange<In, Out, Convert>(src, dst, channels, 0, nb_samples);
+}
+
+void FloatToS16Scalar(const float* src, int16_t* dst, int nb_samples)
+{
+    for (int i = 0; i < nb_samples; ++i)
+    {
+        dst[i] = FloatSampleToS16(src[i]);
+    }
+}
+
+double SumSquaresFloatScalar(const float* src, int nb_samples)
+{
+    double sum = 0.0;
+    for (int i = 0; i < nb_samples; ++i)
+    {
+        sum += static_cast<double>(src[i]) * src[i];
+    }
+    return sum;
+}
+
+double SumSquaresS16Scalar(const int16_t* src, int nb_samples)
+{
+    int64_t sum = 0;
+    for (int i = 0; i < nb_samples; ++i)
+    {
+        sum += static_cast<int32_t>(src[i]) * src[i];
+    }
+    return static_cast<double>(sum);
+}
+
+#ifdef SAMPLE_CONVERT_X86
+// 通用N声道实现：每 4 个声道一组转置后写入各样本帧内的连续位置，余下的声道两个一组以 64 位写入，最后一个逐样本跨步写入
+void InterleaveFloatStridedSSE2(const float* const* src, float* dst, int channels, int nb_samples)
+{
+    int ch = 0;
+
+    for (; ch + 4 <= channels; ch += 4)
+    {
+        int i = 0;
+        for (; i + 4 <= nb_samples; i += 4)
+        {
+            __m128 c0 = _mm_loadu_ps(src[ch] + i);
+            __m128 c1 = _mm_loadu_ps(src[ch + 1] + i);
+            __m128 c2 = _mm_loadu_ps(src[ch + 2] + i);
+            __m128 c3 = _mm_loadu_ps(src[ch + 3] + i);
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+            float* out = dst + i * channels + ch;
+            _mm_storeu_ps(out, c0);
+            _mm_storeu_ps(out + channels, c1);
+            _mm_storeu_ps(out + 2 * channels, c2);
+            _mm_storeu_ps(out + 3 * channels, c3);
+        }
+
+        for (; i < nb_samples; ++i)
+        {
+            for (int k = 0; k < 4; ++k)
+            {
+                dst[i * channels + ch + k] = src[ch + k][i];
+            }
+        }
+    }
+
+    if (ch + 2 <= channels)
+    {
+        int i = 0;
+        for (; i + 4 <= nb_samples; i += 4)
+        {
+            __m128 a  = _mm_loadu_ps(src[ch] + i);
+            __m128 b  = _mm_loadu_ps(src[ch + 1] + i);
+            __m128 lo = _mm_unpacklo_ps(a, b); // A0 B0 A1 B1
+            __m128 hi = _mm_unpackhi_ps(a, b); // A2 B2 A3 B3
+
+            float* out = dst + i * channels + ch;
+            _mm_storel_pi(reinterpret_cast<__m64*>(out), lo);
+            _mm_storeh_pi(reinterpret_cast<__m64*>(out + channels), lo);
+            _mm_storel_pi(reinterpret_cast<__m64*>(out + 2 * channels), hi);
+            _mm_storeh_pi(reinterpret_cast<__m64*>(out + 3 * channels), hi);
+        }
+
+        for (; i < nb_samples; ++i)
+        {
+            dst[i * channels + ch]     = src[ch][i];
+            dst[i * channels + ch + 1] = src[ch + 1][i];
+        }
+        ch += 2;
+    }
+
+    for (; ch < channels; ++ch)
+    {
+        const float* in  = src[ch];
+        float*       out = dst + ch;
+
+        for (int i = 0; i < nb_samples; ++i)
+        {
+            out[i * channels] = in[i];
+        }
+    }
+}
+
+void InterleaveFloatSSE2(const float* const* src, float* dst, int channels, int nb_samples)
+{
+    if (1 == channels)
+    {
+        memcpy(dst, src[0], sizeof(float) * nb_samples);
+        return;
+    }
+
+    if (2 != channels)
+    {
+        InterleaveFloatStridedSSE2(src, dst, channels, nb_samples);
+        return;
+    }
+
+    const float* left  = src[0];
+    const float* right = src[1];
+    int          i     = 0;
+
+    for (; i + 4 <= nb_samples; i += 4)
+    {
+        __m128 l = _mm_loadu_ps(left + i);
+        __m128 r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(dst + 2 * i, _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(dst + 2 * i + 4, _mm_unpackhi_ps(l, r));
+    }
+
+    for (; i < nb_samples; ++i)
+    {
+        dst[2 * i]     = left[i];
+        dst[2 * i + 1] = right[i];
+    }
+}
+
+// 4路并行 xorshift32，返回[0, 1)内的4个均匀分布随机数
+inline __m128 RandomUnitSSE2(__m128i& state)
+{
+    state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+    state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+    state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+
+    __m128i bits = _mm_or_si128(_mm_srli_epi32(state, 9), _mm_set1_epi32(0x3F800000));
+    return _mm_castsi128_ps(bits);
+}
+
+// 单声道与通用N声道实现：逐声道以 8 个样本为一组向量化缩放、抖动与饱和转换，单声道直接整组写入，多声道跨步写入
+void InterleaveS16StridedSSE2(const float* const* src, int16_t* dst, int channels, int nb_samples,
+                              DitherState* dither)
+{
+    const __m128 scale = _mm_set1_ps(32768.0F);
+    const __m128 low   = _mm_set1_ps(-32768.0F);
+    const __m128 high  = _mm_set1_ps(32767.0F);
+    __m128i      state = dither ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(dither->state)) : _mm_setzero_si128();
+
+    for (int ch = 0; ch < channels; ++ch)
+    {
+        const float* in  = src[ch];
+        int16_t*     out = dst + ch;
+        int          i   = 0;
+
+        for (; i + 8 <= nb_samples; i += 8)
+        {
+            __m128 a = _mm_mul_ps(_mm_loadu_ps(in + i), scale);
+            __m128 b = _mm_mul_ps(_mm_loadu_ps(in + i + 4), scale);
+
+            if (dither)
+            {
+                a = _mm_add_ps(a, _mm_sub_ps(RandomUnitSSE2(state), RandomUnitSSE2(state)));
+                b = _mm_add_ps(b, _mm_sub_ps(RandomUnitSSE2(state), RandomUnitSSE2(state)));
+            }
+
+            a = _mm_min_ps(_mm_max_ps(a, low), high);
+            b = _mm_min_ps(_mm_max_ps(b, low), high);
+
+            __m128i value = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+            if (1 == channels)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), value);
+                continue;
+            }
+
+            alignas(16) int16_t samples[8];
+            _mm_store_si128(reinterpret_cast<__m128i*>(samples), value);
+            for (int k = 0; k < 8; ++k)
+            {
+                out[(i + k) * channels] = samples[k];
+            }
+        }
+
+        if (i < nb_samples)
+        {
+            // 尾部使用第一路的标量状态，前后与向量状态交接，随机数序列不重复
+            if (dither)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dither->state), state);
+            }
+
+            for (; i < nb_samples; ++i)
+            {
+                float noise       = dither ? RandomUnit(dither->state[0]) - RandomUnit(dither->state[0]) : 0.0F;
+                out[i * channels] = FloatToS16(in[i], noise);
+            }
+
+            if (dither)
+            {
+                state = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dither->state));
+            }
+        }
+    }
+
+    if (dither)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dither->state), state);
+    }
+}
+
+void InterleaveS16SSE2(const float* const* src, int16_t* dst, int channels, int nb_samples, DitherState* dither)
+{
+    if (2 != channels)
+    {
+        InterleaveS16StridedSSE2(src, dst, channels, nb_samples, dither);
+        return;
+    }
+
+    const float* left  = src[0];
+    const float* right = src[1];
+    const __m128 scale = _mm_set1_ps(32768.0F);
+    __m128i      state = dither ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(dither->state)) : _mm_setzero_si128();
+    int          i     = 0;
+
+    for (; i + 4 <= nb_samples; i += 4)
+    {
+        __m128 l = _mm_mul_ps(_mm_loadu_ps(left + i), scale);
+        __m128 r = _mm_mul_ps(_mm_loadu_ps(right + i), scale);
+
+        if (dither)
+        {
+            l = _mm_add_ps(l, _mm_sub_ps(RandomUnitSSE2(state), RandomUnitSSE2(state)));
+            r = _mm_add_ps(r, _mm_sub_ps(RandomUnitSSE2(state), RandomUnitSSE2(state)));
+        }
+
+        // cvtps 溢出时得到 0x80000000，先饱和到int32可表示的范围再转换，packs 负责截断到int16
+        l = _mm_min_ps(_mm_max_ps(l, _mm_set1_ps(-32768.0F)), _mm_set1_ps(32767.0F));
+        r = _mm_min_ps(_mm_max_ps(r, _mm_set1_ps(-32768.0F)), _mm_set1_ps(32767.0F));
+
+        __m128i li = _mm_cvtps_epi32(l);
+        __m128i ri = _mm_cvtps_epi32(r);
+        __m128i lr = _mm_packs_epi32(_mm_unpacklo_epi32(li, ri), _mm_unpackhi_epi32(li, ri));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), lr);
+    }
+
+    if (dither)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dither->state), state);
+    }
+
+    for (; i < nb_samples; ++i)
+    {
+        float noise_l  = dither ? RandomUnit(dither->state[0]) - RandomUnit(dither->state[0]) : 0.0F;
+        float noise_r  = dither ? RandomUnit(dither->state[0]) - RandomUnit(dither->state[0]) : 0.0F;
+        dst[2 * i]     = FloatToS16(left[i], noise_l);
+        dst[2 * i + 1] = FloatToS16(right[i], noise_r);
+    }
+}
+
+// 4 个交错立体声样本帧(a: L0 R0 L1 R1, b: L2 R2 L3 R3)拆分为左右声道
+inline void SplitStereo(__m128 a, __m128 b, __m128& left, __m128& right)
+{
+    left  = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+inline void SplitStereo(__m128i a, __m128i b, __m128i& left, __m128i& right)
+{
+    __m128 l;
+    __m128 r;
+    SplitStereo(_mm_castsi128_ps(a), _mm_castsi128_ps(b), l, r);
+    left  = _mm_castps_si128(l);
+    right = _mm_castps_si128(r);
+}
+
+// 8 个浮点样本饱和转换为 16 位整数
+inline __m128i FloatToS16x8(__m128 a, __m128 b)
+{
+    const __m128 scale = _mm_set1_ps(32768.0F);
+    const __m128 low   = _mm_set1_ps(-32768.0F);
+    const __m128 high  = _mm_set1_ps(32767.0F);
+
+    a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(a, scale), low), high);
+    b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(b, scale), low), high);
+    return _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+}
+
+inline __m128 S24ToFloatx4(__m128i value)
+{
+    return _mm_mul_ps(_mm_cvtepi32_ps(_mm_slli_epi32(value, 8)), _mm_set1_ps(1.0F / 2147483648.0F));
+}
+
+// 结果仍为 32 位，+32768 的情况由之后的 packs 饱和
+inline __m128i S24ToS16x4(__m128i value)
+{
+    value = _mm_srai_epi32(_mm_slli_epi32(value, 8), 8);
+    return _mm_srai_epi32(_mm_add_epi32(value, _mm_set1_epi32(128)), 8);
+}
+
+inline __m128i LoadS128(const void* src)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+inline void StoreS128(void* dst, __m128i value)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), value);
+}
+
+void DeinterleaveFloatSSE2(const float* src, float* const* dst, int channels, int nb_samples)
+{
+    if (1 == channels)
+    {
+        memcpy(dst[0], src, sizeof(float) * nb_samples);
+        return;
+    }
+
+    if (2 != channels)
+    {
+        DeinterleaveScalar<float, float, FloatSampleToFloat>(src, dst, channels, nb_samples);
+        return;
+    }
+
+    int i = 0;
+    for (; i + 4 <= nb_samples; i += 4)
+    {
+        __m128 left;
+        __m128 right;
+        SplitStereo(_mm_loadu_ps(src + 2 * i), _mm_loadu_ps(src + 2 * i + 4), left, right);
+        _mm_storeu_ps(dst[0] + i, left);
+        _mm_storeu_ps(dst[1] + i, right);
+    }
+    DeinterleaveRange<float, float, FloatSampleToFloat>(src, dst, channels, i, nb_samples);
+}
+
+void DeinterleaveS16ToFloatSSE2(const int16_t* src, float* const* dst, int channels, int nb_samples)
+{
+    if (channels > 2)
+    {
+        DeinterleaveScalar<int16_t, float, S16SampleToFloat>(src, dst, channels, nb_samples);
+        return;
+    }
+
+    const __m128 scale = _mm_set1_ps(1.0F / 32768.0F);
+    int          step  = 8 / channels; // 每次读取 8 个样本
+    int          i     = 0;
+
+    for (; i + step <= nb_samples; i += step)
+    {
+        // 与自身交错后算术右移，得到符号扩展的 32 位整数
+        __m128i value = LoadS128(src + i * channels);
+        __m128  lo    = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(value, value), 16)), scale);
+        __m128  hi    = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(value, value), 16)), scale);
+
+        if (1 == channels)
+        {
+            _mm_storeu_ps(dst[0] + i, lo);
+            _mm_storeu_ps(dst[0] + i + 4, hi);
+        }
+        else
+        {
+            __m128 left;
+            __m128 right;
+            SplitStereo(lo, hi, left, right);
+            _mm_storeu_ps(dst[0] + i, left);
+            _mm_storeu_ps(dst[1] + i, right);
+        }
+    }
+    DeinterleaveRange<int16_t, float, S16SampleToFloat>(src, dst, channels, i, nb_samples);
+}
+
+void DeinterleaveS24ToFloatSSE2(const int32_t* src, float* const* dst, int channels, int nb_samples)
+{
+    if (channels > 2)
+    {
+        DeinterleaveScalar<int32_t, float, S24SampleToFloat>(src, dst, channels, nb_samples);
+        return;
+    }
+
+    int step = 8 / channels;
+    int i    = 0;
+
+    for (; i + step <= nb_samples; i += step)
+    {
+        __m128 lo = S24ToFloatx4(LoadS128(src + i * channels));
+        __m128 hi = S24ToFloatx4(LoadS128(src + i * channels + 4));
+
+        if (1 == channels)
+        {
+            _mm_storeu_ps(dst[0] + i, lo);
+            _mm_storeu_ps(dst[0] + i + 4, hi);
+        }
+        else
+        {
+            __m128 left;
+            __m128 right;
+            SplitStereo(lo, hi, left, right);
+            _mm_storeu_ps(dst[0] + i, left);
+            _mm_storeu_ps(dst[1] + i, right);
+        }
+    }
+    DeinterleaveRange<int32_t, float, S24SampleToFloat>(src, dst, channels, i, nb_samples);
+}
+
+void DeinterleaveS16SSE2(const int16_t* src, int16_t* const* dst, int channels, int nb_samples)
+{
+    if (1 == channels)
+    {
+        memcpy(dst[0], src, sizeof(int16_t) * nb_samples);
+        return;
+    }
+
+    if (2 != channels)
+    {
+        DeinterleaveScalar<int16_t, int16_t, S16SampleToS16>(src, dst, channels, nb_samples);
+        return;
+    }
+
+    int i = 0;
+    for (; i + 8 <= nb_samples; i += 8)
+    {
+        // 每个 32 位通道为一个样本帧，低 16 位是左声道，高 16 位是右声道
+        __m128i a = LoadS128(src + 2 * i);
+        __m128i b = LoadS128(src + 2 * i + 8);
+        __m128i l = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                                    _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+        __m128i r = _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+        StoreS128(dst[0] + i, l);
+        StoreS128(dst[1] + i, r);
+    }
+    DeinterleaveRange<int16_t, int16_t, S16SampleToS16>(src, dst, channels, i, nb_samples);
+}
+
+void DeinterleaveS24ToS16SSE2(const int32_t* src, int16_t* const* dst, int channels, int nb_samples)
+{
+    if (channels > 2)
+    {
+        DeinterleaveScalar<int32_t, int16_t, S24SampleToS16>(src, dst, channels, nb_samples);
+        return;
+    }
+
+    int i = 0;
+    if (1 == channels)
+    {
+        for (; i + 8 <= nb_samples; i += 8)
+        {
+            StoreS128(dst[0] + i, _mm_packs_epi32(S24ToS16x4(LoadS128(src + i)), S24ToS16x4(LoadS128(src + i + 4))));
+        }
+    }
+    else
+    {
+        for (; i + 8 <= nb_samples; i += 8)
+        {
+            __m128i l0;
+            __m128i r0;
+            __m128i l1;
+            __m128i r1;
+            SplitStereo(S24ToS16x4(LoadS128(src + 2 * i)), S24ToS16x4(LoadS128(src + 2 * i + 4)), l0, r0);
+            SplitStereo(S24ToS16x4(LoadS128(src + 2 * i + 8)), S24ToS16x4(LoadS128(src + 2 * i + 12)), l1, r1);
+            StoreS128(dst[0] + i, _mm_packs_epi32(l0, l1));
+            StoreS128(dst[1] + i, _mm_packs_epi32(r0, r1));
+        }
+    }
+    DeinterleaveRange<int32_t, int16_t, S24SampleToS16>(src, dst, channels, i, nb_samples);
+}
+
+void FloatToS16SSE2(const float* src, int16_t* dst, int nb_samples)
+{
+    int i = 0;
+    for (; i + 8 <= nb_samples; i += 8)
+    {
+        StoreS128(dst + i, FloatToS16x8(_mm_loadu_ps(src + i), _mm_loadu_ps(src + i + 4)));
+    }
+
+    for (; i < nb_samples; ++i)
+    {
+        dst[i] = FloatSampleToS16(src[i]);
+    }
+}
+
+void DeinterleaveFloatToS16SSE2(const float* src, int16_t* const* dst, int channels, int nb_samples)
+{
+    if (1 == channels)
+    {
+        FloatToS16SSE2(src, dst[0], nb_samples);
+        return;
+    }
+
+    if (2 != channels)
+    {
+        DeinterleaveScalar<float, int16_t, FloatSampleToS16>(src, dst, channels, nb_samples);
+        return;
+    }
+
+    int i = 0;
+    for (; i + 8 <= nb_samples; i += 8)
+    {
+        __m128 l0;
+        __m128 r0;
+        __m128 l1;
+        __m128 r1;
+        SplitStereo(_mm_loadu_ps(src + 2 * i), _mm_loadu_ps(src + 2 * i + 4), l0, r0);
+        SplitStereo(_mm_loadu_ps(src + 2 * i + 8), _mm_loadu_ps(src + 2 * i + 12), l1, r1);
+        StoreS128(dst[0] + i, FloatToS16x8(l0, l1));
+        StoreS128(dst[1] + i, FloatToS16x8(r0, r1));
+    }
+    DeinterleaveRange<float, int16_t, FloatSampleToS16>(src, dst, channels, i, nb_samples);
+}
+
+// 4 路单精度部分和，一帧(约千个样本)内的累计误差远小于检测门限的精度要求
+double SumSquaresFloatSSE2(const float* src, int nb_samples)
+{
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    int    i    = 0;
+
+    for (; i + 8 <= nb_samples; i += 8)
+    {
+        __m128 a = _mm_loadu_ps(src + i);
+        __m128 b = _mm_loadu_ps(src + i + 4);
+        acc0     = _mm_add_ps(acc0, _mm_mul_ps(a, a));
+        acc1     = _mm_add_ps(acc1, _mm_mul_ps(b, b));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    double sum = static_cast<double>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+
+    return sum + SumSquaresFloatScalar(src + i, nb_samples - i);
+}
+
+// madd 得到相邻两个样本的平方和(最大 2^31，按无符号数处理)，零扩展后累加到 64 位
+double SumSquaresS16SSE2(const int16_t* src, int nb_samples)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i       acc  = _mm_setzero_si128();
+    int           i    = 0;
+
+    for (; i + 8 <= nb_samples; i += 8)
+    {
+        __m128i value   = LoadS128(src + i);
+        __m128i squares = _mm_madd_epi16(value, value);
+        acc             = _mm_add_epi64(acc, _mm_unpacklo_epi32(squares, zero));
+        acc             = _mm_add_epi64(acc, _mm_unpackhi_epi32(squares, zero));
+    }
+
+    uint64_t lanes[2];
+    StoreS128(lanes, acc);
+    double sum = static_cast<double>(lanes[0] + lanes[1]);
+
+    return sum + SumSquaresS16Scalar(src + i, nb_samples - i);
+}
+
+__attribute__((target("avx2"))) void InterleaveFloatAVX2(const float* const* src, float* dst, int channels,
+                                                         int nb_samples)
+{
+    if (2 != channels)
+    {
+        InterleaveFloatSSE2(src, dst, channels, nb_samples);
+        return;
+    }
+
+    const float* left  = src[0];
+    const float* right = src[1];
+    int          i     = 0;
+
+    for (; i + 8 <= nb_samples; i += 8)
+    {
+        __m256 l  = _mm256_loadu_ps(left + i);
+        __m256 r  = _mm256_loadu_ps(right + i);
+        __m256 lo = _mm256_unpacklo_ps(l, r); // L0 R0 L1 R1 | L4 R4 L5 R5
+        __m256 hi = _mm256_unpackhi_ps(l, r); // L2 R2 L3 R3 | L6 R6 L7 R7
+        _mm256_storeu_ps(dst + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(dst + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+
+    for (; i < nb_samples; ++i)
+    {
+        dst[2 * i]     = left[i];
+        dst[2 * i + 1] = right[i];
+    }
+}
+#endif
+
+SampleConvertKernels SelectKernels()
+{
+#ifdef SAMPLE_CONVERT_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return {"avx2",
+                InterleaveFloatAVX2,
+                InterleaveS16SSE2,
+                DeinterleaveS16ToFloatSSE2,
+                DeinterleaveS24ToFloatSSE2,
+                DeinterleaveFloatSSE2,
+                DeinterleaveS16SSE2,
+                DeinterleaveS24ToS16SSE2,
+                DeinterleaveFloatToS16SSE2,
+                FloatToS16SSE2,
+                SumSquaresFloatSSE2,
+                SumSquaresS16SSE2};
+    }
+
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return {"sse2",
+                InterleaveFloatSSE2,
+                InterleaveS16SSE2,
+                DeinterleaveS16ToFloatSSE2,
+                DeinterleaveS24ToFloatSSE2,
+                DeinterleaveFloatSSE2,
+                DeinterleaveS16SSE2,
+                DeinterleaveS24ToS16SSE2,
+                DeinterleaveFloatToS16SSE2,
+                FloatToS16SSE2,
+                SumSquaresFloatSSE2,
+                SumSquaresS16SSE2};
+    }
+#endif
+
+    return {"scalar",
+            InterleaveFloatScalar,
+            InterleaveS16Scalar,
+            DeinterleaveScalar<int16_t, float, S16SampleToFloat>,
+            DeinterleaveScalar<int32_t, float, S24SampleToFloat>,
+            DeinterleaveScalar<float, float, FloatSampleToFloat>,
+            DeinterleaveScalar<int16_t, int16_t, S16SampleToS16>,
+            DeinterleaveScalar<int32_t, int16_t, S24SampleToS16>,
+            DeinterleaveScalar<float, int16_t, FloatSampleToS16>,
+            FloatToS16Scalar,
+            SumSquaresFloatScalar,
+            SumSquaresS16Scalar};
+}
+
+const SampleConvertKernels& Kernels()
+{
+    static const SampleConvertKernels kernels = SelectKernels();
+    return kernels;
+}
+} // namespace
+
+void InterleaveFloat(const float* const* src, float* dst, int channels, int nb_samples)
+{
+    Kernels().interleave_float(src, dst, channels, nb_samples);
+}
+
+void InitDitherState(DitherState& dither, uint32_t seed)
+{
+    // xorshift 状态不能为0
+    for (int i = 0; i < 4; ++i)
+    {
+        dither.state[i] = (seed + 0x9E3779B9U * (i + 1)) | 1U;
+    }
+}
+
+void InterleaveFloatToS16(const float* const* src, int16_t* dst, int channels, int nb_samples, DitherState* dither)
+{
+    Kernels().interleave_s16(src, dst, channels, nb_samples, dither);
+}
+
+void DeinterleaveS16ToFloat(const int16_t* src, float* const* dst, int channels, int nb_samples)
+{
+    Kernels().deinterleave_s16_to_float(src, dst, channels, nb_samples);
+}
+
+void DeinterleaveS24ToFloat(const int32_t* src, float* const* dst, int channels, int nb_samples)
+{
+    Kernels().deinterleave_s24_to_float(src, dst, channels, nb_samples);
+}
+
+void DeinterleaveFloat(const float* src, float* const* dst, int channels, int nb_samples)
+{
+    Kernels().deinterleave_float(src, dst, channels, nb_samples);
+}
+
+void DeinterleaveS16(const int16_t* src, int16_t* const* dst, int channels, int nb_samples)
+{
+    Kernels().deinterleave_s16(src, dst, channels, nb_samples);
+}
+
+void DeinterleaveS24ToS16(const int32_t* src, int16_t* const* dst, int channels, int nb_samples)
+{
+    Kernels().deinterleave_s24_to_s16(src, dst, channels, nb_samples);
+}
+
+void DeinterleaveFloatToS16(const float* src, int16_t* const* dst, int channels, int nb_samples)
+{
+    Kernels().deinterleave_float_to_s16(src, dst, channels, nb_samples);
+}
+
+void ConvertFloatToS16(const float* src, int16_t* dst, int nb_samples)
+{
+    Kernels().float_to_s16(src, dst, nb_samples);
+}
+
+double SumSquaresFloat(const float* src, int nb_samples)
+{
+    return Kernels().sum_squares_float(src, nb_samples);
+}
+
+double SumSquaresS16(const int16_t* src, int nb_samples)
+{
+    return Kernels().sum_squares_s16(src, nb_samples);
+}
+
+const char* SampleConvertKernelName()
+{
+    return Kernels().name;
+}
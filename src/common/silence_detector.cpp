@@ -0,0 +1,72 @@
+#include <silence_detector.h>
+#include <sample_convert.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+SilenceDetector::SilenceDetector(const SilenceConfig& config, int channels, AVSampleFormat format)
+    : config_(config)
+    , channels_(channels)
+    , format_(format)
+    , threshold_(std::pow(10.0, config.threshold_db / 10.0))
+    , silent_frames_(0)
+{
+    if (AV_SAMPLE_FMT_FLTP != format_ && AV_SAMPLE_FMT_S16P != format_)
+    {
+        throw std::runtime_error("Unsupported sample format for silence detection");
+    }
+
+    config_.hangover_frames = std::max(config_.hangover_frames, 2);
+}
+
+bool SilenceDetector::Skip(const uint8_t* const* planes, int nb_samples)
+{
+    if (!IsSilent(planes, nb_samples))
+    {
+        silent_frames_ = 0;
+        return false;
+    }
+
+    // 达到挂起帧数之前的静音帧照常编码
+    if (silent_frames_ < config_.hangover_frames)
+    {
+        ++silent_frames_;
+        return false;
+    }
+
+    return true;
+}
+
+bool SilenceDetector::IsSilent(const uint8_t* const* planes, int nb_samples) const
+{
+    if (nb_samples <= 0)
+    {
+        return false;
+    }
+
+    // 16 位整数的满幅度为 32768
+    double limit = threshold_ * nb_samples;
+    if (AV_SAMPLE_FMT_S16P == format_)
+    {
+        limit *= 32768.0 * 32768.0;
+    }
+
+    for (int ch = 0; ch < channels_; ++ch)
+    {
+        double energy = (AV_SAMPLE_FMT_FLTP == format_)
+                            ? SumSquaresFloat(reinterpret_cast<const float*>(planes[ch]), nb_samples)
+                            : SumSquaresS16(reinterpret_cast<const int16_t*>(planes[ch]), nb_samples);
+        if (energy >= limit)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void SilenceDetector::Reset()
+{
+    silent_frames_ = 0;
+}
@@ -0,0 +1,113 @@
+#include <stream_parser.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+StreamParser::StreamParser(AVCodecID codec_id)
+    : codec_id_(codec_id)
+    , parser_(nullptr)
+{
+    tail_.fill(0);
+}
+
+StreamParser::~StreamParser()
+{
+    if (parser_)
+    {
+        av_parser_close(parser_);
+    }
+}
+
+bool StreamParser::Parse(AVCodecContext* codec_context, const uint8_t* data, size_t size,
+                         const StreamParserFrameCallbackType& callback)
+{
+    if (!parser_)
+    {
+        parser_ = av_parser_init(codec_id_);
+        if (!parser_)
+        {
+            std::cerr << "Could not allocate parser" << std::endl;
+            return false;
+        }
+    }
+
+    // 距离末尾超过填充长度的部分原地解析
+    size_t direct = size > AV_INPUT_BUFFER_PADDING_SIZE ? size - AV_INPUT_BUFFER_PADDING_SIZE : 0;
+    if (!ParseRange(codec_context, data, direct, callback))
+    {
+        return false;
+    }
+
+    // 剩余部分拷贝到暂存区，其后的填充字节保持为 0
+    size_t remain = size - direct;
+    if (remain > 0)
+    {
+        memcpy(tail_.data(), data + direct, remain);
+        memset(tail_.data() + remain, 0, tail_.size() - remain);
+    }
+
+    return ParseRange(codec_context, tail_.data(), remain, callback);
+}
+
+bool StreamParser::Flush(AVCodecContext* codec_context, const StreamParserFrameCallbackType& callback)
+{
+    if (!parser_)
+    {
+        return true;
+    }
+
+    // 空输入使解析器输出缓存中的最后一帧
+    uint8_t* out      = nullptr;
+    int      out_size = 0;
+    av_parser_parse2(parser_, codec_context, &out, &out_size, nullptr, 0, AV_NOPTS_VALUE, AV_NOPTS_VALUE, 0);
+
+    bool ret = true;
+    if (out_size > 0)
+    {
+        ret = callback(out, static_cast<size_t>(out_size));
+    }
+
+    Reset();
+
+    return ret;
+}
+
+void StreamParser::Reset()
+{
+    // 解析器没有重置接口，关闭后在下次解析时重新创建
+    if (parser_)
+    {
+        av_parser_close(parser_);
+        parser_ = nullptr;
+    }
+}
+
+bool StreamParser::ParseRange(AVCodecContext* codec_context, const uint8_t* data, size_t size,
+                              const StreamParserFrameCallbackType& callback)
+{
+    while (size > 0)
+    {
+        uint8_t* out      = nullptr;
+        int      out_size = 0;
+        int      length   = static_cast<int>(std::min<size_t>(size, INT_MAX - AV_INPUT_BUFFER_PADDING_SIZE));
+
+        int used = av_parser_parse2(parser_, codec_context, &out, &out_size, data, length, AV_NOPTS_VALUE,
+                                    AV_NOPTS_VALUE, 0);
+        if (used < 0)
+        {
+            std::cerr << "Error while parsing" << std::endl;
+            return false;
+        }
+
+        data += used;
+        size -= used;
+
+        if (out_size > 0 && !callback(out, static_cast<size_t>(out_size)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,143 @@
+#include <work_stealing_pool.h>
+
+#include <algorithm>
+
+namespace
+{
+// 当前线程所属的线程池及其队列序号，用于将工作线程提交的任务放入本地队列
+thread_local WorkStealingPool* current_pool  = nullptr;
+thread_local int               current_index = -1;
+} // namespace
+
+WorkStealingPool::WorkStealingPool(int threads)
+    : pending_(0U)
+    , next_queue_(0U)
+    , stop_(false)
+{
+    if (threads <= 0)
+    {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    for (int i = 0; i < threads; ++i)
+    {
+        queues_.emplace_back(new WorkerQueue());
+    }
+
+    for (int i = 0; i < threads; ++i)
+    {
+        threads_.emplace_back(&WorkStealingPool::WorkerThread, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stop_ = true;
+    }
+    sleep_cond_.notify_all();
+
+    for (std::thread& thread : threads_)
+    {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::Submit(TaskType task)
+{
+    Push(std::move(task), false);
+}
+
+void WorkStealingPool::Yield(TaskType task)
+{
+    Push(std::move(task), true);
+}
+
+int WorkStealingPool::ThreadCount() const
+{
+    return static_cast<int>(threads_.size());
+}
+
+void WorkStealingPool::Push(TaskType task, bool front)
+{
+    size_t index = (this == current_pool) ? static_cast<size_t>(current_index)
+                                          : next_queue_.fetch_add(1U, std::memory_order_relaxed) % queues_.size();
+
+    pending_.fetch_add(1U, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        if (front)
+        {
+            queues_[index]->tasks.push_front(std::move(task));
+        }
+        else
+        {
+            queues_[index]->tasks.push_back(std::move(task));
+        }
+    }
+
+    // 先获取再释放休眠锁，保证等待线程不会错过本次唤醒
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    sleep_cond_.notify_one();
+}
+
+bool WorkStealingPool::PopTask(int index, TaskType& task)
+{
+    // 优先执行本地队列尾部最新提交的任务
+    {
+        WorkerQueue&                queue = *queues_[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // 本地队列为空时从其他队列头部窃取最早提交的任务
+    size_t count = queues_.size();
+    for (size_t i = 1; i < count; ++i)
+    {
+        WorkerQueue&                queue = *queues_[(index + i) % count];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingPool::WorkerThread(int index)
+{
+    current_pool  = this;
+    current_index = index;
+
+    while (true)
+    {
+        TaskType task;
+        if (PopTask(index, task))
+        {
+            pending_.fetch_sub(1U, std::memory_order_acq_rel);
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        sleep_cond_.wait(lock, [this] { return stop_ || pending_.load(std::memory_order_acquire) > 0; });
+        if (stop_ && 0 == pending_.load(std::memory_order_acquire))
+        {
+            break;
+        }
+    }
+
+    current_pool  = nullptr;
+    current_index = -1;
+}
@@ -1,11 +1,15 @@
 #include <audio_decoder_aac.h>
+#include <codec_log.h>
 
-AudioDecoderAAC::AudioDecoderAAC()
+AudioDecoderAAC::AudioDecoderAAC(const AudioOutputFormat& output_format, int sample_rate, int channels)
     : codec_(nullptr)
     , codec_context_(nullptr)
     , frame_(nullptr)
     , pkt_(nullptr)
+    , parser_(AV_CODEC_ID_AAC)
+    , output_converter_(output_format)
     , callback_(nullptr)
+    , frame_callback_(nullptr)
 {
 #if LIBAVCODEC_VERSION_MAJOR < 58 // 若 libavcodec < 58则注册所有解码器，否则只注册aac
     avcodec_register_all();
@@ -25,20 +29,39 @@ AudioDecoderAAC::AudioDecoderAAC()
         return;
     }
 
-    const enum AVSampleFormat* p = codec_->sample_fmts;
-    std::cout << "AAC Supported sample formats: ";
-    while (*p != AV_SAMPLE_FMT_NONE)
+    LogSupportedSampleFormats(codec_, "AAC");
+
+    // 未指定参数时由解码器从每帧的 ADTS 头中解析采样率与声道数，码流参数变化时自动跟随
+    if (sample_rate > 0 && channels > 0)
     {
-        std::cout << av_get_sample_fmt_name(*p) << " ";
-        p++;
-    }
-    std::cout << std::endl;
+        static const int sample_rates[] = {96000, 88200, 64000, 48000, 44100, 32000, 24000,
+                                           22050, 16000, 12000, 11025, 8000,  7350};
 
-    // 假设已知的采样率、声道数等参数（实际应从ADTS头中解析）
-    codec_context_->sample_rate    = 44100; // 采样率
-    codec_context_->channels       = 2;     // 声道数
-    codec_context_->channel_layout = av_get_default_channel_layout(2);
-    codec_context_->sample_fmt     = codec_->sample_fmts ? codec_->sample_fmts[0] : AV_SAMPLE_FMT_FLTP;
+        int frequency_index = -1;
+        for (int i = 0; i < 13; ++i)
+        {
+            if (sample_rates[i] == sample_rate)
+            {
+                frequency_index = i;
+                break;
+            }
+        }
+
+        if (frequency_index < 0 || channels > 7)
+        {
+            throw std::runtime_error("Unsupported AAC sample rate or channel count");
+        }
+
+        // AudioSpecificConfig: audioObjectType(5) = 2(AAC-LC), samplingFrequencyIndex(4), channelConfiguration(4)
+        codec_context_->extradata = static_cast<uint8_t*>(av_mallocz(2 + AV_INPUT_BUFFER_PADDING_SIZE));
+        if (!codec_context_->extradata)
+        {
+            throw std::runtime_error("Could not allocate extradata");
+        }
+        codec_context_->extradata[0]   = (2 << 3) | (frequency_index >> 1);
+        codec_context_->extradata[1]   = ((frequency_index & 1) << 7) | (channels << 3);
+        codec_context_->extradata_size = 2;
+    }
 
     if (avcodec_open2(codec_context_, codec_, nullptr) < 0)
     {
@@ -65,45 +88,255 @@ AudioDecoderAAC::~AudioDecoderAAC()
     avcodec_free_context(&codec_context_);
 }
 
-bool AudioDecoderAAC::Decode(uint8_t* data, size_t size)
+bool AudioDecoderAAC::Decode(const uint8_t* data, size_t size)
 {
-    pkt_->data = data;
-    pkt_->size = size;
+    return DecodePacket(data, size);
+}
+
+bool AudioDecoderAAC::DecodeStream(const uint8_t* data, size_t size)
+{
+    // 解析出的帧指向输入块内部，直接送入解码器；单帧解码失败不中断分帧，块内其余帧照常解码
+    bool decoded = true;
+    bool parsed  = parser_.Parse(codec_context_, data, size, [this, &decoded](const uint8_t* frame, size_t frame_size) {
+        decoded = DecodePacket(frame, frame_size) && decoded;
+        return true;
+    });
 
-    if (avcodec_send_packet(codec_context_, pkt_) < 0)
+    return parsed && decoded;
+}
+
+bool AudioDecoderAAC::FlushStream()
+{
+    bool decoded = true;
+    bool parsed  = parser_.Flush(codec_context_, [this, &decoded](const uint8_t* frame, size_t frame_size) {
+        decoded = DecodePacket(frame, frame_size) && decoded;
+        return true;
+    });
+
+    // 空包使解码器输出内部缓存的帧，排空后须重置才能接收新的码流
+    int ret = avcodec_send_packet(codec_context_, nullptr);
+    if (ret < 0 && ret != AVERROR_EOF)
     {
-        std::cerr << "Error sending the packet to the decoder" << std::endl;
+        stats_.RecordError();
+        std::cerr << "Error draining the decoder" << std::endl;
+        decoded = false;
+    }
+    else
+    {
+        decoded = ReceiveFrames() && decoded;
+    }
+    avcodec_flush_buffers(codec_context_);
+
+    // 最后取出重采样器中的延迟样本
+    return DrainConverter() && parsed && decoded;
+}
+
+bool AudioDecoderAAC::DecodePacket(const uint8_t* data, size_t size)
+{
+    // avcodec_send_packet 会为非引用计数的包新分配缓冲区并拷贝，这里改为拷贝到池化缓冲区，
+    // 稳态下不再有按包的堆分配；填充字节由池缓冲区提供，调用方无需预留
+    if (!packet_pool_.Fill(pkt_, data, size))
+    {
+        stats_.RecordError();
+        std::cerr << "Could not allocate packet buffer" << std::endl;
         return false;
     }
 
-    while (avcodec_receive_frame(codec_context_, frame_) == 0)
+    if (stats_)
     {
-        if (callback_)
-        {
-            int buffer_size = av_samples_get_buffer_size(nullptr, codec_context_->channels, frame_->nb_samples,
-                                                         codec_context_->sample_fmt, 1);
+        stats_->AddFramesIn(1, size);
+    }
+
+    int ret = 0;
+    {
+        CodecStageTimer timer(stats_.Get(), CodecStage::kSend);
+        ret = avcodec_send_packet(codec_context_, pkt_);
+    }
+    if (ret < 0)
+    {
+        stats_.RecordError();
+        std::cerr << "Error sending the packet to the decoder" << std::endl;
+        return false;
+    }
 
-            // 如果是平面格式（如fltp），需要分别处理每个声道的数据
-            std::vector<uint8_t> interleaved_buffer(buffer_size);
+    bool received = ReceiveFrames();
+    av_packet_unref(pkt_);
+
+    return received;
+}
 
-            // 将各声道的数据交织在一起
-            for (int sample = 0; sample < frame_->nb_samples; ++sample)
+bool AudioDecoderAAC::ReceiveFrames()
+{
+    int ret = 0;
+
+    for (;;)
+    {
+        {
+            CodecStageTimer timer(stats_.Get(), CodecStage::kReceive);
+            ret = avcodec_receive_frame(codec_context_, frame_);
+        }
+        if (ret < 0)
+        {
+            // EAGAIN 表示需要更多输入，EOF 表示已排空，其余为解码错误
+            if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
             {
-                for (int ch = 0; ch < codec_context_->channels; ++ch)
-                {
-                    float* src = reinterpret_cast<float*>(frame_->data[ch]);
-                    float* dst = reinterpret_cast<float*>(interleaved_buffer.data());
+                stats_.RecordError();
+            }
+            break;
+        }
 
-                    dst[sample * codec_context_->channels + ch] = src[sample];
-                }
+        // 没有输出回调时跳过格式转换，开启响度测量时仍测量本帧
+        if (!callback_ && !frame_callback_)
+        {
+            output_converter_.Measure(frame_);
+            if (stats_)
+            {
+                stats_->AddFramesOut(1, 0);
             }
+            continue;
+        }
+
+        // 码流参数变化将重建重采样器，先取出旧重采样器中的延迟样本
+        if (output_converter_.ResamplerChanges(frame_) && !DrainConverter())
+        {
+            return false;
+        }
 
-            // 将交织后的数据传递给回调函数
-            callback_(interleaved_buffer.data(), buffer_size);
+        // 按构造时指定的输出格式转换，平面输出直接引用帧数据
+        AudioFrameView view;
+        bool           converted = false;
+        {
+            CodecStageTimer timer(stats_.Get(), CodecStage::kConvert);
+            converted = output_converter_.Convert(frame_, view);
+        }
+        if (!converted)
+        {
+            stats_.RecordError();
+            std::cerr << "Failed to convert decoded frame" << std::endl;
+            return false;
         }
+
+        DeliverFrame(view);
     }
 
+    return true;
+}
+
+bool AudioDecoderAAC::DrainConverter()
+{
+    AudioFrameView view;
+    if (!output_converter_.Flush(view))
+    {
+        stats_.RecordError();
+        return false;
+    }
+
+    if (view.nb_samples > 0 && (callback_ || frame_callback_))
+    {
+        DeliverFrame(view);
+    }
+
+    return true;
+}
+
+void AudioDecoderAAC::DeliverFrame(const AudioFrameView& view)
+{
+    if (stats_)
+    {
+        stats_->AddFramesOut(1, view.plane_size * view.planes);
+    }
+
+    CodecStageTimer timer(stats_.Get(), CodecStage::kCallback);
+    if (frame_callback_)
+    {
+        frame_callback_(view);
+    }
+
+    // 字节回调只接收交错格式
+    if (callback_ && 1 == view.planes)
+    {
+        callback_(const_cast<uint8_t*>(view.data[0]), view.plane_size);
+    }
+}
+
+bool AudioDecoderAAC::Reset()
+{
+    // 清空解码器内部缓存的帧与重叠状态，之后的数据包按新的码流开始解码
+    avcodec_flush_buffers(codec_context_);
     av_packet_unref(pkt_);
+    parser_.Reset();
+
+    return output_converter_.Reset();
+}
+
+void AudioDecoderAAC::ReleaseBuffers()
+{
+    output_converter_.ReleaseBuffers();
+}
+
+void AudioDecoderAAC::ClearCallbacks()
+{
+    callback_       = nullptr;
+    frame_callback_ = nullptr;
+}
+
+void AudioDecoderAAC::EnableStats(bool enable)
+{
+    stats_.Enable(enable);
+}
+
+bool AudioDecoderAAC::GetStats(CodecStatsSnapshot& snapshot) const
+{
+    return stats_.Snapshot(snapshot);
+}
+
+void AudioDecoderAAC::ResetStats()
+{
+    stats_.Reset();
+}
+
+bool AudioDecoderAAC::EnableLoudness(bool enable)
+{
+    if (!codec_context_)
+    {
+        return false;
+    }
+
+    return output_converter_.EnableLoudness(enable, codec_context_->sample_fmt);
+}
+
+bool AudioDecoderAAC::GetLoudness(LoudnessSnapshot& snapshot) const
+{
+    const LoudnessMeter* meter = output_converter_.Loudness();
+    if (!meter)
+    {
+        return false;
+    }
+
+    meter->Snapshot(snapshot);
+
+    return true;
+}
+
+CodecMemoryUsage AudioDecoderAAC::MemoryUsage() const
+{
+    // 输入包在 Decode 返回前已释放，平面输出直接引用解码器的帧，只有输出格式转换的缓冲区随实例保留
+    CodecMemoryUsage usage;
+    usage.instance = sizeof(*this) + (stats_ ? sizeof(CodecStats) : 0U);
+    usage.buffers  = output_converter_.MemoryUsage();
+
+    return usage;
+}
+
+bool AudioDecoderAAC::InstallFrameCallback(AACAudioDecoderFrameCallbackType callback)
+{
+    if (!callback)
+    {
+        return false;
+    }
+
+    frame_callback_ = callback;
+
     return true;
 }
 
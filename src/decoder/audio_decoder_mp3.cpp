@@ -1,11 +1,14 @@
 #include "audio_decoder_mp3.h"
 
-AudioDecoderMP3::AudioDecoderMP3()
+AudioDecoderMP3::AudioDecoderMP3(const AudioOutputFormat& output_format)
     : codec_(nullptr)
     , codec_context_(nullptr)
     , frame_(nullptr)
     , pkt_(nullptr)
+    , parser_(AV_CODEC_ID_MP3)
+    , output_converter_(output_format)
     , callback_(nullptr)
+    , frame_callback_(nullptr)
 {
 #if LIBAVCODEC_VERSION_MAJOR < 58
     avcodec_register_all();
@@ -52,45 +55,255 @@ AudioDecoderMP3::~AudioDecoderMP3()
     avcodec_free_context(&codec_context_);
 }
 
-bool AudioDecoderMP3::Decode(uint8_t* data, size_t size)
+bool AudioDecoderMP3::Decode(const uint8_t* data, size_t size)
 {
-    pkt_->data = data;
-    pkt_->size = size;
+    return DecodePacket(data, size);
+}
+
+bool AudioDecoderMP3::DecodeStream(const uint8_t* data, size_t size)
+{
+    // 解析出的帧指向输入块内部，直接送入解码器；单帧解码失败不中断分帧，块内其余帧照常解码
+    bool decoded = true;
+    bool parsed  = parser_.Parse(codec_context_, data, size, [this, &decoded](const uint8_t* frame, size_t frame_size) {
+        decoded = DecodePacket(frame, frame_size) && decoded;
+        return true;
+    });
+
+    return parsed && decoded;
+}
+
+bool AudioDecoderMP3::FlushStream()
+{
+    bool decoded = true;
+    bool parsed  = parser_.Flush(codec_context_, [this, &decoded](const uint8_t* frame, size_t frame_size) {
+        decoded = DecodePacket(frame, frame_size) && decoded;
+        return true;
+    });
 
-    if (avcodec_send_packet(codec_context_, pkt_) < 0)
+    // 空包使解码器输出内部缓存的帧，排空后须重置才能接收新的码流
+    int ret = avcodec_send_packet(codec_context_, nullptr);
+    if (ret < 0 && ret != AVERROR_EOF)
     {
-        std::cerr << "Error sending the packet to the decoder" << std::endl;
+        stats_.RecordError();
+        std::cerr << "Error draining the decoder" << std::endl;
+        decoded = false;
+    }
+    else
+    {
+        decoded = ReceiveFrames() && decoded;
+    }
+    avcodec_flush_buffers(codec_context_);
+
+    // 最后取出重采样器中的延迟样本
+    return DrainConverter() && parsed && decoded;
+}
+
+bool AudioDecoderMP3::DecodePacket(const uint8_t* data, size_t size)
+{
+    // avcodec_send_packet 会为非引用计数的包新分配缓冲区并拷贝，这里改为拷贝到池化缓冲区，
+    // 稳态下不再有按包的堆分配；填充字节由池缓冲区提供，调用方无需预留
+    if (!packet_pool_.Fill(pkt_, data, size))
+    {
+        stats_.RecordError();
+        std::cerr << "Could not allocate packet buffer" << std::endl;
         return false;
     }
 
-    while (avcodec_receive_frame(codec_context_, frame_) == 0)
+    if (stats_)
     {
-        if (callback_)
-        {
-            int buffer_size = av_samples_get_buffer_size(nullptr, codec_context_->channels, frame_->nb_samples,
-                                                         codec_context_->sample_fmt, 1);
+        stats_->AddFramesIn(1, size);
+    }
 
-            // 如果是平面格式（如fltp），需要分别处理每个声道的数据
-            std::vector<uint8_t> interleaved_buffer(buffer_size);
+    int ret = 0;
+    {
+        CodecStageTimer timer(stats_.Get(), CodecStage::kSend);
+        ret = avcodec_send_packet(codec_context_, pkt_);
+    }
+    if (ret < 0)
+    {
+        stats_.RecordError();
+        std::cerr << "Error sending the packet to the decoder" << std::endl;
+        return false;
+    }
+
+    bool received = ReceiveFrames();
+    av_packet_unref(pkt_);
+
+    return received;
+}
+
+bool AudioDecoderMP3::ReceiveFrames()
+{
+    int ret = 0;
 
-            // 将各声道的数据交织在一起
-            for (int sample = 0; sample < frame_->nb_samples; ++sample)
+    for (;;)
+    {
+        {
+            CodecStageTimer timer(stats_.Get(), CodecStage::kReceive);
+            ret = avcodec_receive_frame(codec_context_, frame_);
+        }
+        if (ret < 0)
+        {
+            // EAGAIN 表示需要更多输入，EOF 表示已排空，其余为解码错误
+            if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
             {
-                for (int ch = 0; ch < codec_context_->channels; ++ch)
-                {
-                    float* src = reinterpret_cast<float*>(frame_->data[ch]);
-                    float* dst = reinterpret_cast<float*>(interleaved_buffer.data());
+                stats_.RecordError();
+            }
+            break;
+        }
 
-                    dst[sample * codec_context_->channels + ch] = src[sample];
-                }
+        // 没有输出回调时跳过格式转换，开启响度测量时仍测量本帧
+        if (!callback_ && !frame_callback_)
+        {
+            output_converter_.Measure(frame_);
+            if (stats_)
+            {
+                stats_->AddFramesOut(1, 0);
             }
+            continue;
+        }
+
+        // 码流参数变化将重建重采样器，先取出旧重采样器中的延迟样本
+        if (output_converter_.ResamplerChanges(frame_) && !DrainConverter())
+        {
+            return false;
+        }
 
-            // 将交织后的数据传递给回调函数
-            callback_(interleaved_buffer.data(), buffer_size);
+        // 按构造时指定的输出格式转换，平面输出直接引用帧数据
+        AudioFrameView view;
+        bool           converted = false;
+        {
+            CodecStageTimer timer(stats_.Get(), CodecStage::kConvert);
+            converted = output_converter_.Convert(frame_, view);
+        }
+        if (!converted)
+        {
+            stats_.RecordError();
+            std::cerr << "Failed to convert decoded frame" << std::endl;
+            return false;
         }
+
+        DeliverFrame(view);
+    }
+
+    return true;
+}
+
+bool AudioDecoderMP3::DrainConverter()
+{
+    AudioFrameView view;
+    if (!output_converter_.Flush(view))
+    {
+        stats_.RecordError();
+        return false;
+    }
+
+    if (view.nb_samples > 0 && (callback_ || frame_callback_))
+    {
+        DeliverFrame(view);
+    }
+
+    return true;
+}
+
+void AudioDecoderMP3::DeliverFrame(const AudioFrameView& view)
+{
+    if (stats_)
+    {
+        stats_->AddFramesOut(1, view.plane_size * view.planes);
+    }
+
+    CodecStageTimer timer(stats_.Get(), CodecStage::kCallback);
+    if (frame_callback_)
+    {
+        frame_callback_(view);
     }
 
+    // 字节回调只接收交错格式
+    if (callback_ && 1 == view.planes)
+    {
+        callback_(const_cast<uint8_t*>(view.data[0]), view.plane_size);
+    }
+}
+
+bool AudioDecoderMP3::Reset()
+{
+    // 清空解码器内部缓存的帧与重叠状态，之后的数据包按新的码流开始解码
+    avcodec_flush_buffers(codec_context_);
     av_packet_unref(pkt_);
+    parser_.Reset();
+
+    return output_converter_.Reset();
+}
+
+void AudioDecoderMP3::ReleaseBuffers()
+{
+    output_converter_.ReleaseBuffers();
+}
+
+void AudioDecoderMP3::ClearCallbacks()
+{
+    callback_       = nullptr;
+    frame_callback_ = nullptr;
+}
+
+void AudioDecoderMP3::EnableStats(bool enable)
+{
+    stats_.Enable(enable);
+}
+
+bool AudioDecoderMP3::GetStats(CodecStatsSnapshot& snapshot) const
+{
+    return stats_.Snapshot(snapshot);
+}
+
+void AudioDecoderMP3::ResetStats()
+{
+    stats_.Reset();
+}
+
+bool AudioDecoderMP3::EnableLoudness(bool enable)
+{
+    if (!codec_context_)
+    {
+        return false;
+    }
+
+    return output_converter_.EnableLoudness(enable, codec_context_->sample_fmt);
+}
+
+bool AudioDecoderMP3::GetLoudness(LoudnessSnapshot& snapshot) const
+{
+    const LoudnessMeter* meter = output_converter_.Loudness();
+    if (!meter)
+    {
+        return false;
+    }
+
+    meter->Snapshot(snapshot);
+
+    return true;
+}
+
+CodecMemoryUsage AudioDecoderMP3::MemoryUsage() const
+{
+    // 输入包在 Decode 返回前已释放，平面输出直接引用解码器的帧，只有输出格式转换的缓冲区随实例保留
+    CodecMemoryUsage usage;
+    usage.instance = sizeof(*this) + (stats_ ? sizeof(CodecStats) : 0U);
+    usage.buffers  = output_converter_.MemoryUsage();
+
+    return usage;
+}
+
+bool AudioDecoderMP3::InstallFrameCallback(MP3AudioDecoderFrameCallbackType callback)
+{
+    if (!callback)
+    {
+        return false;
+    }
+
+    frame_callback_ = callback;
+
     return true;
 }
 
@@ -0,0 +1,189 @@
+#include <adts_demuxer.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+const int kAdtsSampleRates[16] = {96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050,
+                                  16000, 12000, 11025, 8000,  7350,  0,     0,     0};
+} // namespace
+
+AdtsDemuxer::AdtsDemuxer(const uint8_t* data, size_t size)
+    : data_(data)
+    , size_(size)
+    , total_samples_(0)
+    , uniform_samples_(0U)
+    , sample_rate_(0)
+    , channels_(0)
+    , profile_(0)
+    , skipped_bytes_(0U)
+{
+    Scan();
+}
+
+size_t AdtsDemuxer::FrameCount() const
+{
+    return frames_.size();
+}
+
+bool AdtsDemuxer::GetFrame(size_t index, AdtsFrame& frame) const
+{
+    if (index >= frames_.size())
+    {
+        return false;
+    }
+
+    const FrameIndexEntry& entry = frames_[index];
+    frame.data                   = data_ + entry.offset;
+    frame.size                   = entry.size;
+    frame.payload                = frame.data + entry.header_size;
+    frame.payload_size           = entry.size - entry.header_size;
+    frame.sample_position        = entry.sample_position;
+    frame.samples                = entry.raw_blocks * kSamplesPerRawBlock;
+
+    return true;
+}
+
+bool AdtsDemuxer::Seek(int64_t sample, size_t preroll_frames, AdtsSeekPosition& position) const
+{
+    if (frames_.empty() || sample < 0 || sample >= total_samples_)
+    {
+        return false;
+    }
+
+    size_t index = 0;
+    if (uniform_samples_ > 0)
+    {
+        // 帧长固定时直接计算帧序号，O(1)
+        index = static_cast<size_t>(sample / uniform_samples_);
+    }
+    else
+    {
+        auto it = std::upper_bound(frames_.begin(), frames_.end(), sample,
+                                   [](int64_t value, const FrameIndexEntry& entry) {
+                                       return value < entry.sample_position;
+                                   });
+        index   = static_cast<size_t>(it - frames_.begin()) - 1;
+    }
+
+    // AAC 帧之间存在 MDCT 重叠，需要从目标帧之前若干帧开始解码才能得到与顺序解码相同的输出
+    size_t start          = (index > preroll_frames) ? index - preroll_frames : 0U;
+    position.frame_index  = start;
+    position.skip_samples = static_cast<uint32_t>(sample - frames_[start].sample_position);
+
+    return true;
+}
+
+int64_t AdtsDemuxer::TotalSamples() const
+{
+    return total_samples_;
+}
+
+int AdtsDemuxer::SampleRate() const
+{
+    return sample_rate_;
+}
+
+int AdtsDemuxer::Channels() const
+{
+    return channels_;
+}
+
+int AdtsDemuxer::Profile() const
+{
+    return profile_;
+}
+
+size_t AdtsDemuxer::SkippedBytes() const
+{
+    return skipped_bytes_;
+}
+
+void AdtsDemuxer::Scan()
+{
+    size_t offset = 0;
+
+    while (offset + 7 <= size_)
+    {
+        FrameIndexEntry entry;
+        if (ParseHeader(offset, entry))
+        {
+            // 重新同步之后的第一帧要求下一帧也能对齐，避免把负载中的 0xFFF 误判为帧头
+            size_t expected = frames_.empty() ? 0U : frames_.back().offset + frames_.back().size;
+            bool   resynced = (offset != expected);
+            size_t next     = offset + entry.size;
+            if (!resynced || next + 2 > size_ || IsSync(next))
+            {
+                entry.sample_position = total_samples_;
+                total_samples_ += entry.raw_blocks * kSamplesPerRawBlock;
+                frames_.push_back(entry);
+                offset = next;
+                continue;
+            }
+        }
+
+        // 用 memchr(libc 中为向量化实现)查找下一个可能的同步字节
+        const uint8_t* found = static_cast<const uint8_t*>(memchr(data_ + offset + 1, 0xFF, size_ - offset - 1));
+        size_t         next  = found ? static_cast<size_t>(found - data_) : size_;
+        skipped_bytes_ += next - offset;
+        offset = next;
+    }
+
+    if (frames_.empty())
+    {
+        return;
+    }
+
+    const uint8_t* header = data_ + frames_.front().offset;
+    profile_              = (header[2] >> 6) & 0x03;
+    sample_rate_          = kAdtsSampleRates[(header[2] >> 2) & 0x0F];
+    channels_             = ((header[2] & 0x01) << 2) | ((header[3] >> 6) & 0x03);
+
+    uniform_samples_ = frames_.front().raw_blocks * kSamplesPerRawBlock;
+    for (const FrameIndexEntry& entry : frames_)
+    {
+        if (entry.raw_blocks * kSamplesPerRawBlock != uniform_samples_)
+        {
+            uniform_samples_ = 0U;
+            break;
+        }
+    }
+}
+
+bool AdtsDemuxer::ParseHeader(size_t offset, FrameIndexEntry& entry) const
+{
+    const uint8_t* header = data_ + offset;
+
+    // 同步字 0xFFF，layer 必须为 0
+    if (!IsSync(offset) || (header[1] & 0x06) != 0)
+    {
+        return false;
+    }
+
+    if (0 == kAdtsSampleRates[(header[2] >> 2) & 0x0F])
+    {
+        return false;
+    }
+
+    bool   protection_absent = header[1] & 0x01;
+    size_t header_size       = protection_absent ? 7U : 9U;
+    size_t frame_length      = ((header[3] & 0x03) << 11) | (header[4] << 3) | ((header[5] & 0xE0) >> 5);
+
+    if (frame_length <= header_size || offset + frame_length > size_)
+    {
+        return false;
+    }
+
+    entry.offset      = offset;
+    entry.size        = static_cast<uint16_t>(frame_length);
+    entry.header_size = static_cast<uint8_t>(header_size);
+    entry.raw_blocks  = static_cast<uint8_t>((header[6] & 0x03) + 1);
+
+    return true;
+}
+
+bool AdtsDemuxer::IsSync(size_t offset) const
+{
+    return offset + 2 <= size_ && 0xFF == data_[offset] && 0xF0 == (data_[offset + 1] & 0xF6);
+}
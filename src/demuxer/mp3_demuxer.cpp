@@ -0,0 +1,355 @@
+#include <mp3_demuxer.h>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+// 比特率表(kbps)，下标为帧头中的 bitrate_index，0 为自由格式，15 非法
+const int kBitrates[5][16] = {
+    {0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0}, // MPEG-1 Layer I
+    {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0},    // MPEG-1 Layer II
+    {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0},     // MPEG-1 Layer III
+    {0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0},    // MPEG-2/2.5 Layer I
+    {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0},         // MPEG-2/2.5 Layer II/III
+};
+
+const int kSampleRates[3][3] = {
+    {44100, 48000, 32000}, // MPEG-1
+    {22050, 24000, 16000}, // MPEG-2
+    {11025, 12000, 8000},  // MPEG-2.5
+};
+} // namespace
+
+Mp3Demuxer::Mp3Demuxer(const uint8_t* data, size_t size)
+    : data_(data)
+    , size_(size)
+    , total_samples_(0)
+    , uniform_samples_(0U)
+    , sample_rate_(0)
+    , channels_(0)
+    , skipped_bytes_(0U)
+{
+    Scan();
+}
+
+bool Mp3Demuxer::ParseHeader(const uint8_t* header, Mp3FrameHeader& info)
+{
+    if (0xFF != header[0] || 0xE0 != (header[1] & 0xE0))
+    {
+        return false;
+    }
+
+    int version_bits  = (header[1] >> 3) & 0x03;
+    int layer_bits    = (header[1] >> 1) & 0x03;
+    int bitrate_index = (header[2] >> 4) & 0x0F;
+    int rate_index    = (header[2] >> 2) & 0x03;
+    int padding       = (header[2] >> 1) & 0x01;
+
+    // 保留值均视为非法帧头；自由格式(bitrate_index为0)无法从帧头得到帧长，不支持
+    if (1 == version_bits || 0 == layer_bits || 0 == bitrate_index || 15 == bitrate_index || 3 == rate_index
+        || 2 == (header[3] & 0x03))
+    {
+        return false;
+    }
+
+    info.version = (3 == version_bits) ? 1 : ((2 == version_bits) ? 2 : 25);
+    info.layer   = 4 - layer_bits;
+
+    int table = 0;
+    if (1 == info.version)
+    {
+        table = info.layer - 1;
+    }
+    else
+    {
+        table = (1 == info.layer) ? 3 : 4;
+    }
+
+    info.bitrate     = kBitrates[table][bitrate_index] * 1000;
+    info.sample_rate = kSampleRates[(1 == info.version) ? 0 : ((2 == info.version) ? 1 : 2)][rate_index];
+    info.channels    = (3 == (header[3] >> 6)) ? 1 : 2;
+    info.crc         = 0 == (header[1] & 0x01);
+
+    if (1 == info.layer)
+    {
+        info.samples    = 384;
+        info.frame_size = (12 * info.bitrate / info.sample_rate + padding) * 4;
+    }
+    else if (2 == info.layer || 1 == info.version)
+    {
+        info.samples    = 1152;
+        info.frame_size = 144 * info.bitrate / info.sample_rate + padding;
+    }
+    else
+    {
+        // MPEG-2/2.5 Layer III 每帧只有一个 granule
+        info.samples    = 576;
+        info.frame_size = 72 * info.bitrate / info.sample_rate + padding;
+    }
+
+    return info.frame_size > 4;
+}
+
+size_t Mp3Demuxer::FrameCount() const
+{
+    return frames_.size();
+}
+
+bool Mp3Demuxer::GetFrame(size_t index, Mp3Frame& frame) const
+{
+    if (index >= frames_.size())
+    {
+        return false;
+    }
+
+    const FrameIndexEntry& entry = frames_[index];
+    frame.data                   = data_ + entry.offset;
+    frame.size                   = entry.size;
+    frame.sample_position        = entry.sample_position;
+    frame.samples                = entry.samples;
+
+    return true;
+}
+
+bool Mp3Demuxer::FindFrame(int64_t sample, size_t& index) const
+{
+    if (frames_.empty() || sample < 0 || sample >= total_samples_)
+    {
+        return false;
+    }
+
+    if (uniform_samples_ > 0)
+    {
+        index = static_cast<size_t>(sample / uniform_samples_);
+        return true;
+    }
+
+    auto it = std::upper_bound(frames_.begin(), frames_.end(), sample, [](int64_t value, const FrameIndexEntry& entry) {
+        return value < entry.sample_position;
+    });
+    index   = static_cast<size_t>(it - frames_.begin()) - 1;
+
+    return true;
+}
+
+bool Mp3Demuxer::ReservoirStart(size_t index, size_t& start) const
+{
+    uint32_t main_data_begin = 0U;
+    uint32_t main_data_size  = 0U;
+    if (!ParseMainData(index, main_data_begin, main_data_size))
+    {
+        return false;
+    }
+
+    // main_data_begin 为本帧主数据相对帧头向前回溯的字节数，只计前面各帧的主数据区
+    start = index;
+    while (main_data_begin > 0 && start > 0)
+    {
+        --start;
+        uint32_t previous_begin = 0U;
+        if (!ParseMainData(start, previous_begin, main_data_size))
+        {
+            return false;
+        }
+        main_data_begin -= std::min(main_data_begin, main_data_size);
+    }
+
+    return true;
+}
+
+int64_t Mp3Demuxer::TotalSamples() const
+{
+    return total_samples_;
+}
+
+int Mp3Demuxer::SampleRate() const
+{
+    return sample_rate_;
+}
+
+int Mp3Demuxer::Channels() const
+{
+    return channels_;
+}
+
+size_t Mp3Demuxer::SkippedBytes() const
+{
+    return skipped_bytes_;
+}
+
+bool Mp3Demuxer::ParseMainData(size_t index, uint32_t& main_data_begin, uint32_t& main_data_size) const
+{
+    if (index >= frames_.size())
+    {
+        return false;
+    }
+
+    const FrameIndexEntry& entry  = frames_[index];
+    const uint8_t*         header = data_ + entry.offset;
+    Mp3FrameHeader         info;
+    if (!ParseHeader(header, info))
+    {
+        return false;
+    }
+
+    if (3 != info.layer)
+    {
+        main_data_begin = 0U;
+        main_data_size  = 0U;
+        return true;
+    }
+
+    // 侧信息：MPEG-1 单声道 17 字节、立体声 32 字节；MPEG-2/2.5 单声道 9 字节、立体声 17 字节
+    size_t side_offset = 4 + (info.crc ? 2 : 0);
+    size_t side_size   = (1 == info.version) ? ((1 == info.channels) ? 17 : 32) : ((1 == info.channels) ? 9 : 17);
+    if (side_offset + side_size > entry.size)
+    {
+        return false;
+    }
+
+    // main_data_begin 在 MPEG-1 中占 9 位，在 MPEG-2/2.5 中占 8 位
+    const uint8_t* side = header + side_offset;
+    if (1 == info.version)
+    {
+        main_data_begin = (static_cast<uint32_t>(side[0]) << 1) | (side[1] >> 7);
+    }
+    else
+    {
+        main_data_begin = side[0];
+    }
+    main_data_size = static_cast<uint32_t>(entry.size - side_offset - side_size);
+
+    return true;
+}
+
+void Mp3Demuxer::Scan()
+{
+    size_t         offset = 0;
+    Mp3FrameHeader stream = {};
+
+    while (offset + 4 <= size_)
+    {
+        size_t tag_size = TagSize(offset);
+        if (tag_size > 0)
+        {
+            offset += tag_size;
+            continue;
+        }
+
+        Mp3FrameHeader info;
+        if (ParseHeader(data_ + offset, info) && offset + info.frame_size <= size_)
+        {
+            bool in_sync = !frames_.empty() && frames_.back().offset + frames_.back().size == offset;
+            bool valid   = frames_.empty() || Matches(offset, stream);
+            size_t next  = offset + info.frame_size;
+
+            // 非连续位置找到的候选帧(文件开头或重新同步后)要求下一帧帧头同样合法且参数一致
+            if (valid && !in_sync)
+            {
+                valid = next + 4 > size_ || TagSize(next) > 0 || Matches(next, info);
+            }
+
+            if (valid)
+            {
+                if (frames_.empty())
+                {
+                    stream = info;
+                }
+
+                frames_.push_back({offset, static_cast<uint16_t>(info.frame_size), static_cast<uint16_t>(info.samples),
+                                   total_samples_});
+                total_samples_ += info.samples;
+                offset = next;
+                continue;
+            }
+        }
+
+        size_t next = FindSync(offset + 1);
+        skipped_bytes_ += next - offset;
+        offset = next;
+    }
+
+    if (frames_.empty())
+    {
+        return;
+    }
+
+    sample_rate_     = stream.sample_rate;
+    channels_        = stream.channels;
+    uniform_samples_ = stream.samples; // 同一流中版本与层一致，每帧样本数固定
+}
+
+size_t Mp3Demuxer::TagSize(size_t offset) const
+{
+    const uint8_t* p = data_ + offset;
+
+    // ID3v2: "ID3" + 版本(2) + 标志(1) + 同步安全整数表示的标签长度(4)
+    if (offset + 10 <= size_ && 0 == memcmp(p, "ID3", 3) && p[3] < 0xFF && p[4] < 0xFF
+        && 0 == ((p[6] | p[7] | p[8] | p[9]) & 0x80))
+    {
+        size_t size = (static_cast<size_t>(p[6]) << 21) | (p[7] << 14) | (p[8] << 7) | p[9];
+        size += (p[5] & 0x10) ? 20U : 10U; // 标志位 0x10 表示带 10 字节尾部
+
+        return std::min(size, size_ - offset);
+    }
+
+    // ID3v1: 文件末尾固定 128 字节的 "TAG"
+    if (offset + 128 == size_ && 0 == memcmp(p, "TAG", 3))
+    {
+        return 128U;
+    }
+
+    return 0U;
+}
+
+bool Mp3Demuxer::Matches(size_t offset, const Mp3FrameHeader& info) const
+{
+    Mp3FrameHeader next;
+
+    return offset + 4 <= size_ && ParseHeader(data_ + offset, next) && next.version == info.version
+        && next.layer == info.layer && next.sample_rate == info.sample_rate;
+}
+
+size_t Mp3Demuxer::FindSync(size_t offset) const
+{
+#if defined(__SSE2__)
+    // 一次比较16个位置：当前字节为 0xFF 且下一字节高3位全为1
+    const __m128i ff   = _mm_set1_epi8(static_cast<char>(0xFF));
+    const __m128i high = _mm_set1_epi8(static_cast<char>(0xE0));
+
+    for (; offset + 17 <= size_; offset += 16)
+    {
+        __m128i a    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data_ + offset));
+        __m128i b    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data_ + offset + 1));
+        __m128i hit  = _mm_and_si128(_mm_cmpeq_epi8(a, ff), _mm_cmpeq_epi8(_mm_and_si128(b, high), high));
+        int     mask = _mm_movemask_epi8(hit);
+        if (mask)
+        {
+            return offset + __builtin_ctz(mask);
+        }
+    }
+#endif
+
+    while (offset + 1 < size_)
+    {
+        const uint8_t* found = static_cast<const uint8_t*>(memchr(data_ + offset, 0xFF, size_ - offset - 1));
+        if (!found)
+        {
+            break;
+        }
+
+        offset = static_cast<size_t>(found - data_);
+        if (0xE0 == (data_[offset + 1] & 0xE0))
+        {
+            return offset;
+        }
+        ++offset;
+    }
+
+    return size_;
+}
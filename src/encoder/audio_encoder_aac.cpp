@@ -1,155 +1,128 @@
 #include <audio_encoder_aac.h>
 
-AudioEncoderAAC::AudioEncoderAAC(int64_t bitrate, int sample_rate, int channels)
-    : bytes_per_sample_(0)
-    , sample_rate_(sample_rate)
-    , channels_(channels)
-    , counter_(0U)
-    , codec_(nullptr)
-    , codec_context_(nullptr)
-    , frame_(nullptr)
-    , pkt_(nullptr)
-    , swr_ctx_(nullptr)
-    , adts_header_(new uint8_t[7U](), std::default_delete<uint8_t[]>())
-    , callback_(nullptr)
-{
-#if LIBAVCODEC_VERSION_MAJOR < 58 // 若 libavcodec < 58则注册所有编码器，否则只注册aac
-    avcodec_register_all();
-#endif
-
-    codec_ = avcodec_find_encoder(AV_CODEC_ID_AAC);
-    if (!codec_)
-    {
-        std::cerr << "Codec not found" << std::endl;
-        return;
-    }
-
-    codec_context_ = avcodec_alloc_context3(codec_);
-    if (!codec_context_)
-    {
-        std::cerr << "Could not allocate audio codec context" << std::endl;
-        return;
-    }
-
-    const enum AVSampleFormat* p = codec_->sample_fmts;
-    std::cout << "AAC Supported sample formats: ";
-    while (*p != AV_SAMPLE_FMT_NONE)
-    {
-        std::cout << av_get_sample_fmt_name(*p) << " ";
-        p++;
-    }
-    std::cout << std::endl;
-
-    codec_context_->bit_rate       = bitrate;
-    codec_context_->sample_fmt     = AV_SAMPLE_FMT_FLTP; // AAC编码器支持的格式, 平面浮点格式
-    codec_context_->sample_rate    = sample_rate_;
-    codec_context_->channel_layout = (2 == channels_) ? AV_CH_LAYOUT_STEREO : AV_CH_LAYOUT_MONO;
-    codec_context_->channels       = channels_;
+AudioEncoderAAC::AudioEncoderAAC(int64_t bitrate, int sample_rate, int channels, bool noise_substitution,
+                                 const AudioInputFormat& input_format, const SilenceConfig& silence)
+    : core_(AV_CODEC_ID_AAC, "AAC", AV_SAMPLE_FMT_FLTP, bitrate, sample_rate, channels, input_format, silence,
+            [noise_substitution](AVCodecContext* codec_context) {
+                // PNS 的噪声由解码器跨帧延续的随机数状态生成，关闭后码流的每帧只依赖预热可恢复的状态
+                if (!noise_substitution && av_opt_set_int(codec_context->priv_data, "aac_pns", 0, 0) < 0)
+                {
+                    std::cerr << "Encoder does not support disabling PNS" << std::endl;
+                }
+            },
+            &AudioEncoderAAC::WriteAdtsHeader)
+{
+}
 
-    if (avcodec_open2(codec_context_, codec_, nullptr) < 0)
-    {
-        throw std::runtime_error("Could not open codec");
-    }
+AudioEncoderAAC::~AudioEncoderAAC()
+{
+}
 
-    frame_                 = av_frame_alloc();
-    frame_->nb_samples     = codec_context_->frame_size;
-    frame_->format         = AV_SAMPLE_FMT_FLTP;
-    frame_->channel_layout = codec_context_->channel_layout;
-    frame_->sample_rate    = codec_context_->sample_rate;
+bool AudioEncoderAAC::Encode(const uint8_t* data, size_t size)
+{
+    return core_.Encode(data, size);
+}
 
-    if (av_frame_get_buffer(frame_, 0) < 0)
-    {
-        throw std::runtime_error("Could not allocate audio frame buffer");
-    }
+bool AudioEncoderAAC::EncodePlanar(const uint8_t* const* planes, int nb_samples)
+{
+    return core_.EncodePlanar(planes, nb_samples);
+}
 
-    AVPacket* pkt = av_packet_alloc();
+bool AudioEncoderAAC::Flush()
+{
+    return core_.Flush();
+}
 
-    if (av_frame_make_writable(frame_) < 0)
-    {
-        throw std::runtime_error("Could not make audio frame writable");
-    }
+bool AudioEncoderAAC::InstallCallback(AACAudioEncoderCallbackType callback)
+{
+    return core_.InstallCallback(callback);
+}
 
-    swr_ctx_ = swr_alloc_set_opts(nullptr, codec_context_->channel_layout, AV_SAMPLE_FMT_FLTP, sample_rate_,
-                                  codec_context_->channel_layout, AV_SAMPLE_FMT_FLT, sample_rate_, 0, nullptr);
+bool AudioEncoderAAC::InstallPacketCallback(AACAudioEncoderPacketCallbackType callback)
+{
+    return core_.InstallPacketCallback(callback);
+}
 
-    if (!swr_ctx_ || swr_init(swr_ctx_) < 0)
-    {
-        throw std::runtime_error("Could not initialize audio resampler");
-    }
+bool AudioEncoderAAC::InstallBatchCallback(AACAudioEncoderBatchCallbackType callback, size_t batch_packets)
+{
+    return core_.InstallBatchCallback(callback, batch_packets);
+}
 
-    bytes_per_sample_ = av_get_bytes_per_sample(AV_SAMPLE_FMT_FLT);
+bool AudioEncoderAAC::InstallGapCallback(AACAudioEncoderGapCallbackType callback)
+{
+    return core_.InstallGapCallback(callback);
+}
 
-    pkt_ = av_packet_alloc();
+int AudioEncoderAAC::FrameSize() const
+{
+    return core_.FrameSize();
 }
 
-AudioEncoderAAC::~AudioEncoderAAC()
+uint64_t AudioEncoderAAC::SkippedFrames() const
 {
-    av_packet_free(&pkt_);
-    av_frame_free(&frame_);
-    avcodec_free_context(&codec_context_);
-    swr_free(&swr_ctx_); // 释放SwrContext
+    return core_.SkippedFrames();
 }
 
-bool AudioEncoderAAC::Encode(uint8_t* data, size_t size)
+CodecMemoryUsage AudioEncoderAAC::MemoryUsage() const
 {
-    int read_samples = size / (bytes_per_sample_ * channels_);
-    if (read_samples < frame_->nb_samples)
-    {
-        std::cerr << "Warning: Incomplete frame read, adjusting nb_samples" << std::endl;
-        frame_->nb_samples = read_samples;
-    }
+    return core_.MemoryUsage(sizeof(*this));
+}
 
-    // 将交错浮点PCM转换为平面浮点PCM
-    const uint8_t* input_data[1]  = {data};
-    uint8_t*       output_data[2] = {frame_->data[0], frame_->data[1]};
-    swr_convert(swr_ctx_, output_data, frame_->nb_samples, input_data, frame_->nb_samples);
+bool AudioEncoderAAC::Reset()
+{
+    return core_.Reset();
+}
 
-    frame_->pts = counter_ * frame_->nb_samples;
-    ++counter_;
+void AudioEncoderAAC::ReleaseBuffers()
+{
+    core_.ReleaseBuffers();
+}
 
-    if (avcodec_send_frame(codec_context_, frame_) < 0)
-    {
-        std::cerr << "Error sending the frame to the encoder" << std::endl;
-        return false;
-    }
+void AudioEncoderAAC::ClearCallbacks()
+{
+    core_.ClearCallbacks();
+}
 
-    while (avcodec_receive_packet(codec_context_, pkt_) == 0)
-    {
-        UpdateAdtsHeader(codec_context_, pkt_->size + 7);
+void AudioEncoderAAC::EnableStats(bool enable)
+{
+    core_.EnableStats(enable);
+}
 
-        if (callback_)
-        {
-            callback_(adts_header_.get(), 7U, pkt_->data, pkt_->size);
-        }
-        av_packet_unref(pkt_);
-    }
+bool AudioEncoderAAC::GetStats(CodecStatsSnapshot& snapshot) const
+{
+    return core_.GetStats(snapshot);
+}
 
-    return true;
+void AudioEncoderAAC::ResetStats()
+{
+    core_.ResetStats();
 }
 
-bool AudioEncoderAAC::InstallCallback(AACAudioEncoderCallbackType callback)
+size_t AudioEncoderAAC::WriteAdtsHeader(const AVCodecContext* codec_context, int payload_size, uint8_t* header)
 {
-    if (!callback)
+    static const int sample_rates[] = {96000, 88200, 64000, 48000, 44100, 32000, 24000,
+                                       22050, 16000, 12000, 11025, 8000,  7350};
+
+    // AAC 编码器只接受表中的采样率
+    int sampling_frequency_index = 4;
+    for (int i = 0; i < 13; ++i)
     {
-        return false;
+        if (sample_rates[i] == codec_context->sample_rate)
+        {
+            sampling_frequency_index = i;
+            break;
+        }
     }
+    int channel_config           = codec_context->channels;
+    int aac_length               = payload_size + 7;
 
-    callback_ = callback;
+    header[0] = 0xFF;
+    header[1] = 0xF9;
+    header[2] = ((codec_context->profile - 1) << 6) + (sampling_frequency_index << 2) + (channel_config >> 2);
+    header[3] = ((channel_config & 3) << 6) + (aac_length >> 11);
+    header[4] = (aac_length & 0x7FF) >> 3;
+    header[5] = ((aac_length & 7) << 5) + 0x1F;
+    header[6] = 0xFC;
 
-    return true;
+    return 7U;
 }
-
-void AudioEncoderAAC::UpdateAdtsHeader(AVCodecContext* codec_context, int aac_length)
-{
-    int sampling_frequency_index = 4; // 默认44.1kHz
-    int channel_config           = codec_context->channels;
-
-    adts_header_.get()[0] = 0xFF;
-    adts_header_.get()[1] = 0xF9;
-    adts_header_.get()[2] =
-        ((codec_context->profile - 1) << 6) + (sampling_frequency_index << 2) + (channel_config >> 2);
-    adts_header_.get()[3] = ((channel_config & 3) << 6) + (aac_length >> 11);
-    adts_header_.get()[4] = (aac_length & 0x7FF) >> 3;
-    adts_header_.get()[5] = ((aac_length & 7) << 5) + 0x1F;
-    adts_header_.get()[6] = 0xFC;
-}
\ No newline at end of file
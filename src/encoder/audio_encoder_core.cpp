@@ -0,0 +1,671 @@
+#include <audio_encoder_core.h>
+#include <codec_log.h>
+
+#include <algorithm>
+
+AudioEncoderCore::AudioEncoderCore(AVCodecID codec_id, const char* name, AVSampleFormat sample_format, int64_t bitrate,
+                                   int sample_rate, int channels, const AudioInputFormat& input_format,
+                                   const SilenceConfig& silence, ConfigureFunctionType configure,
+                                   HeaderFunctionType header)
+    : sample_format_(sample_format)
+    , bitrate_(bitrate)
+    , sample_rate_(sample_rate)
+    , channels_(channels)
+    , counter_(0U)
+    , codec_(nullptr)
+    , codec_context_(nullptr)
+    , frame_(nullptr)
+    , pkt_(nullptr)
+    , frame_pool_(nullptr)
+    , input_converter_(input_format, channels, sample_rate, sample_format)
+    , fifo_(nullptr)
+    , flushed_(false)
+    , configure_(configure)
+    , header_function_(header)
+    , header_()
+    , callback_(nullptr)
+    , packet_callback_(nullptr)
+    , batch_callback_(nullptr)
+    , batch_packets_(0U)
+    , silence_(nullptr)
+    , silence_mode_(silence.mode)
+    , silent_packet_(nullptr)
+    , next_pts_(0)
+    , skipped_frames_(0U)
+    , gap_callback_(nullptr)
+{
+#if LIBAVCODEC_VERSION_MAJOR < 58 // 若 libavcodec < 58则注册所有编码器
+    avcodec_register_all();
+#endif
+
+    codec_ = avcodec_find_encoder(codec_id);
+    if (!codec_)
+    {
+        std::cerr << "Codec not found" << std::endl;
+        return;
+    }
+
+    LogSupportedSampleFormats(codec_, name);
+
+    if (!OpenCodec())
+    {
+        throw std::runtime_error("Could not open codec");
+    }
+
+    frame_                 = av_frame_alloc();
+    frame_->nb_samples     = codec_context_->frame_size; // AAC 为 1024，MP3 的 MPEG-1 为 1152、MPEG-2/2.5 为 576
+    frame_->format         = sample_format_;
+    frame_->channel_layout = codec_context_->channel_layout;
+    frame_->sample_rate    = codec_context_->sample_rate;
+
+    // 帧缓冲区从共享池中获取，编码器仍持有上一帧时换用池中的另一块，不再逐帧分配
+    // 缓冲区与 FIFO 都在首次送入数据时才分配，打开后空闲的实例不占用
+    frame_pool_.reset(new AudioFramePool(sample_format_, channels_, codec_context_->frame_size));
+
+    pkt_ = av_packet_alloc();
+
+    if (SilenceMode::kOff != silence_mode_)
+    {
+        silence_.reset(new SilenceDetector(silence, channels_, sample_format_));
+        if (SilenceMode::kCachedFrame == silence_mode_ && !EncodeSilentPacket())
+        {
+            throw std::runtime_error("Could not encode silent frame");
+        }
+        frame_pool_->ReleaseBuffer(frame_);
+        next_pts_ = -codec_context_->initial_padding;
+    }
+}
+
+bool AudioEncoderCore::OpenCodec()
+{
+    // 重新打开时先释放旧的上下文，编码器内部的预读与延迟状态随之清空
+    avcodec_free_context(&codec_context_);
+
+    codec_context_ = avcodec_alloc_context3(codec_);
+    if (!codec_context_)
+    {
+        std::cerr << "Could not allocate audio codec context" << std::endl;
+        return false;
+    }
+
+    codec_context_->bit_rate       = bitrate_;
+    codec_context_->sample_fmt     = sample_format_;
+    codec_context_->sample_rate    = sample_rate_;
+    codec_context_->channel_layout = (2 == channels_) ? AV_CH_LAYOUT_STEREO : AV_CH_LAYOUT_MONO;
+    codec_context_->channels       = channels_;
+
+    if (configure_)
+    {
+        configure_(codec_context_);
+    }
+
+    // 输出包的缓冲区从池中获取，参数相同的实例共享同一个池
+    packet_pool_.InstallEncodeBuffer(codec_context_);
+
+    // 打开编码器
+    if (avcodec_open2(codec_context_, codec_, nullptr) < 0)
+    {
+        std::cerr << "Could not open codec" << std::endl;
+        avcodec_free_context(&codec_context_);
+        return false;
+    }
+
+    return true;
+}
+
+AudioEncoderCore::~AudioEncoderCore()
+{
+    av_packet_free(&pkt_);
+    av_packet_free(&silent_packet_);
+    av_frame_free(&frame_);
+    avcodec_free_context(&codec_context_);
+    if (fifo_)
+    {
+        av_audio_fifo_free(fifo_);
+    }
+}
+
+bool AudioEncoderCore::Encode(const uint8_t* data, size_t size)
+{
+    if (flushed_)
+    {
+        std::cerr << "Encoder has been flushed" << std::endl;
+        return false;
+    }
+
+    if (!AllocateFifo())
+    {
+        return false;
+    }
+
+    // 上次输入末尾不足一个样本帧的字节先与本次开头的字节拼成完整样本帧，本次末尾的剩余字节留到下次
+    bool written = false;
+    {
+        CodecStageTimer timer(stats_.Get(), CodecStage::kConvert);
+        written = input_converter_.WriteCarry(data, size, fifo_);
+    }
+    if (!written)
+    {
+        stats_.RecordError();
+        std::cerr << "Failed to convert input samples" << std::endl;
+        return false;
+    }
+
+    int total_samples = input_converter_.SampleCount(size);
+    input_converter_.SaveCarry(data, size);
+
+    // 按声明的输入格式分片转换后写入FIFO，任意长度的输入只占用固定大小的转换缓冲区
+    for (int offset = 0; offset < total_samples; offset += AudioInputConverter::kChunkSamples)
+    {
+        int samples = std::min(total_samples - offset, AudioInputConverter::kChunkSamples);
+        {
+            CodecStageTimer timer(stats_.Get(), CodecStage::kConvert);
+            written = input_converter_.Write(data, total_samples, offset, samples, fifo_);
+        }
+        if (!written)
+        {
+            stats_.RecordError();
+            std::cerr << "Failed to convert input samples" << std::endl;
+            return false;
+        }
+
+        if (!EncodeFifoFrames(false))
+        {
+            return false;
+        }
+    }
+
+    if (0 == batch_packets_)
+    {
+        DeliverBatch();
+    }
+
+    return true;
+}
+
+bool AudioEncoderCore::EncodePlanar(const uint8_t* const* planes, int nb_samples)
+{
+    if (flushed_)
+    {
+        std::cerr << "Encoder has been flushed" << std::endl;
+        return false;
+    }
+
+    if (!AllocateFifo())
+    {
+        return false;
+    }
+
+    // 数据直接写入FIFO，FIFO容量不足时自动扩展
+    if (av_audio_fifo_write(fifo_, reinterpret_cast<void**>(const_cast<uint8_t**>(planes)), nb_samples) < nb_samples)
+    {
+        stats_.RecordError();
+        std::cerr << "Could not write data to fifo" << std::endl;
+        return false;
+    }
+
+    if (!EncodeFifoFrames(false))
+    {
+        return false;
+    }
+
+    if (0 == batch_packets_)
+    {
+        DeliverBatch();
+    }
+
+    return true;
+}
+
+bool AudioEncoderCore::Flush()
+{
+    if (flushed_)
+    {
+        return true;
+    }
+
+    if (!AllocateFifo())
+    {
+        return false;
+    }
+
+    // 先排空重采样器并编码FIFO中剩余的不足一帧的数据，再通知编码器输出缓存的数据包
+    if (!input_converter_.Flush(fifo_))
+    {
+        stats_.RecordError();
+        return false;
+    }
+
+    if (!EncodeFifoFrames(true))
+    {
+        return false;
+    }
+
+    flushed_ = true;
+    bool ret = SendFrame(nullptr);
+    DeliverBatch();
+
+    return ret;
+}
+
+bool AudioEncoderCore::EncodeFifoFrames(bool flush)
+{
+    int frame_size = codec_context_->frame_size;
+
+    while (av_audio_fifo_size(fifo_) >= frame_size || (flush && av_audio_fifo_size(fifo_) > 0))
+    {
+        // 编码器可能仍持有上一帧的引用，写入前确保帧缓冲区可写
+        if (!frame_pool_->GetBuffer(frame_))
+        {
+            stats_.RecordError();
+            std::cerr << "Could not make audio frame writable" << std::endl;
+            return false;
+        }
+
+        int samples = std::min(av_audio_fifo_size(fifo_), frame_size);
+        if (av_audio_fifo_read(fifo_, reinterpret_cast<void**>(frame_->data), samples) < samples)
+        {
+            stats_.RecordError();
+            std::cerr << "Could not read data from fifo" << std::endl;
+            return false;
+        }
+
+        // 完整的静音帧不送入编码器，尾部不足一帧的数据总是编码
+        if (silence_ && samples == frame_size && silence_->Skip(frame_->data, samples))
+        {
+            if (!SkipFrame())
+            {
+                return false;
+            }
+            continue;
+        }
+
+        // 不支持短尾帧的编码器需要补静音
+        frame_->nb_samples = samples;
+        if (samples < frame_size && !(codec_->capabilities & AV_CODEC_CAP_SMALL_LAST_FRAME))
+        {
+            av_samples_set_silence(frame_->data, samples, frame_size - samples, channels_, sample_format_);
+            frame_->nb_samples = frame_size;
+        }
+
+        frame_->pts = counter_ * frame_size;
+        ++counter_;
+
+        if (stats_)
+        {
+            stats_->AddFramesIn(1, static_cast<uint64_t>(frame_->nb_samples) * channels_
+                                       * av_get_bytes_per_sample(sample_format_));
+        }
+
+        bool ret           = SendFrame(frame_);
+        frame_->nb_samples = frame_size;
+        if (!ret)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool AudioEncoderCore::SendFrame(AVFrame* frame)
+{
+    int ret = 0;
+    {
+        CodecStageTimer timer(stats_.Get(), CodecStage::kSend);
+        ret = avcodec_send_frame(codec_context_, frame);
+    }
+    if (ret < 0)
+    {
+        stats_.RecordError();
+        std::cerr << "Error sending the frame to the encoder" << std::endl;
+        return false;
+    }
+
+    for (;;)
+    {
+        {
+            CodecStageTimer timer(stats_.Get(), CodecStage::kReceive);
+            ret = avcodec_receive_packet(codec_context_, pkt_);
+        }
+        if (ret < 0)
+        {
+            // EAGAIN 表示需要更多输入，EOF 表示已排空，其余为编码错误
+            if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
+            {
+                stats_.RecordError();
+            }
+            break;
+        }
+
+        DeliverPacket();
+    }
+
+    return true;
+}
+
+void AudioEncoderCore::DeliverPacket()
+{
+    // 开启静音检测时输出包按顺序重新分配时间戳，跳过的帧只会与编码器中缓存的静音帧交换位置
+    if (silence_)
+    {
+        pkt_->pts = next_pts_;
+        next_pts_ += pkt_->duration > 0 ? pkt_->duration : codec_context_->frame_size;
+    }
+
+    if (stats_)
+    {
+        stats_->AddFramesOut(1, pkt_->size);
+    }
+
+    size_t header_size = header_function_ ? header_function_(codec_context_, pkt_->size, header_.data()) : 0U;
+
+    if (callback_)
+    {
+        CodecStageTimer timer(stats_.Get(), CodecStage::kCallback);
+        callback_(header_size > 0 ? header_.data() : nullptr, header_size, pkt_->data, pkt_->size);
+    }
+
+    // 数据包的引用转移给 EncodedPacket，pkt_ 随后被置为空包
+    if (batch_callback_ || packet_callback_)
+    {
+        EncodedPacket packet(pkt_);
+        if (header_size > 0)
+        {
+            packet.SetHeader(header_.data(), header_size);
+        }
+
+        if (batch_callback_)
+        {
+            batch_.push_back(std::move(packet));
+            if (batch_packets_ > 0 && batch_.size() >= batch_packets_)
+            {
+                DeliverBatch();
+            }
+        }
+        else
+        {
+            CodecStageTimer timer(stats_.Get(), CodecStage::kCallback);
+            packet_callback_(std::move(packet));
+        }
+    }
+    av_packet_unref(pkt_);
+}
+
+bool AudioEncoderCore::SkipFrame()
+{
+    int frame_size = codec_context_->frame_size;
+    ++counter_;
+    ++skipped_frames_;
+
+    if (SilenceMode::kCachedFrame == silence_mode_)
+    {
+        if (av_packet_ref(pkt_, silent_packet_) < 0)
+        {
+            stats_.RecordError();
+            std::cerr << "Could not reference silent frame" << std::endl;
+            return false;
+        }
+        DeliverPacket();
+        return true;
+    }
+
+    // 先交付已缓存的批次，保证数据包与静音区间按时间顺序回调
+    DeliverBatch();
+
+    int64_t pts = next_pts_;
+    next_pts_ += frame_size;
+    if (gap_callback_)
+    {
+        CodecStageTimer timer(stats_.Get(), CodecStage::kCallback);
+        gap_callback_(pts, frame_size);
+    }
+
+    return true;
+}
+
+bool AudioEncoderCore::EncodeSilentPacket()
+{
+    // 连续送入静音帧，取编码器进入稳态后输出的数据包，之后重新打开编码器丢弃这些状态
+    int frame_size = codec_context_->frame_size;
+    int packets    = 0;
+
+    silent_packet_ = av_packet_alloc();
+    for (int i = 0; i < 8 && packets < 3; ++i)
+    {
+        if (!frame_pool_->GetBuffer(frame_))
+        {
+            return false;
+        }
+        av_samples_set_silence(frame_->data, 0, frame_size, channels_, sample_format_);
+        frame_->pts = static_cast<int64_t>(i) * frame_size;
+
+        if (avcodec_send_frame(codec_context_, frame_) < 0)
+        {
+            std::cerr << "Error sending the frame to the encoder" << std::endl;
+            return false;
+        }
+
+        while (0 == avcodec_receive_packet(codec_context_, pkt_))
+        {
+            av_packet_unref(silent_packet_);
+            av_packet_move_ref(silent_packet_, pkt_);
+            ++packets;
+        }
+    }
+
+    if (packets < 2)
+    {
+        std::cerr << "Encoder did not produce a silent frame" << std::endl;
+        return false;
+    }
+    silent_packet_->duration = frame_size;
+
+    return OpenCodec();
+}
+
+void AudioEncoderCore::DeliverBatch()
+{
+    if (!batch_callback_ || batch_.empty())
+    {
+        return;
+    }
+
+    // 回调中可以移走数据包，批次容器在回调后清空并复用其容量
+    {
+        CodecStageTimer timer(stats_.Get(), CodecStage::kCallback);
+        batch_callback_(batch_);
+    }
+    batch_.clear();
+}
+
+bool AudioEncoderCore::InstallPacketCallback(PacketCallbackType callback)
+{
+    if (!callback)
+    {
+        return false;
+    }
+
+    packet_callback_ = callback;
+
+    return true;
+}
+
+bool AudioEncoderCore::InstallBatchCallback(BatchCallbackType callback, size_t batch_packets)
+{
+    if (!callback)
+    {
+        return false;
+    }
+
+    batch_callback_ = callback;
+    batch_packets_  = batch_packets;
+    batch_.reserve(batch_packets > 0 ? batch_packets : 8U);
+
+    return true;
+}
+
+bool AudioEncoderCore::InstallGapCallback(GapCallbackType callback)
+{
+    if (!callback)
+    {
+        return false;
+    }
+
+    gap_callback_ = callback;
+
+    return true;
+}
+
+bool AudioEncoderCore::InstallCallback(CallbackType callback)
+{
+    if (!callback)
+    {
+        return false;
+    }
+
+    callback_ = callback;
+
+    return true;
+}
+
+bool AudioEncoderCore::Reset()
+{
+    // 重采样器可能缓存了不足以输出的样本，总是先清空
+    if (!input_converter_.Reset())
+    {
+        stats_.RecordError();
+        return false;
+    }
+
+    if (silence_)
+    {
+        silence_->Reset();
+    }
+
+    // 未送入过数据的实例(如池中预热的实例)无需重置编码器
+    bool used = 0U != counter_ || flushed_ || (fifo_ && av_audio_fifo_size(fifo_) > 0);
+
+    // 只清空缓冲区中的数据，缓冲区本身留给下一路流复用，需要释放时调用 ReleaseBuffers
+    if (fifo_)
+    {
+        av_audio_fifo_reset(fifo_);
+    }
+    batch_.clear();
+
+    if (!used)
+    {
+        return true;
+    }
+
+    // 支持 flush 的编码器直接清空内部状态(含已排空状态)，否则重新创建编码器上下文
+    bool flushable = false;
+#ifdef AV_CODEC_CAP_ENCODER_FLUSH
+    flushable = codec_->capabilities & AV_CODEC_CAP_ENCODER_FLUSH;
+#endif
+    if (flushable)
+    {
+        avcodec_flush_buffers(codec_context_);
+    }
+    else if (!OpenCodec())
+    {
+        stats_.RecordError();
+        return false;
+    }
+
+    av_packet_unref(pkt_);
+    counter_        = 0U;
+    flushed_        = false;
+    skipped_frames_ = 0U;
+    next_pts_       = silence_ ? -codec_context_->initial_padding : 0;
+
+    return true;
+}
+
+void AudioEncoderCore::ClearCallbacks()
+{
+    callback_        = nullptr;
+    packet_callback_ = nullptr;
+    batch_callback_  = nullptr;
+    batch_packets_   = 0U;
+    gap_callback_    = nullptr;
+    batch_.clear();
+}
+
+void AudioEncoderCore::EnableStats(bool enable)
+{
+    stats_.Enable(enable);
+}
+
+bool AudioEncoderCore::GetStats(CodecStatsSnapshot& snapshot) const
+{
+    return stats_.Snapshot(snapshot);
+}
+
+void AudioEncoderCore::ResetStats()
+{
+    stats_.Reset();
+}
+
+bool AudioEncoderCore::AllocateFifo()
+{
+    if (fifo_)
+    {
+        return true;
+    }
+
+    // 输入PCM先转换为编码器原生的平面格式放入FIFO，凑满一帧再送入编码器
+    fifo_ = av_audio_fifo_alloc(sample_format_, channels_, codec_context_->frame_size * 2);
+    if (!fifo_)
+    {
+        stats_.RecordError();
+        std::cerr << "Could not allocate audio fifo" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void AudioEncoderCore::ReleaseBuffers()
+{
+    input_converter_.ReleaseBuffers();
+
+    if (fifo_)
+    {
+        av_audio_fifo_free(fifo_);
+        fifo_ = nullptr;
+    }
+
+    frame_pool_->ReleaseBuffer(frame_);
+    std::vector<EncodedPacket>().swap(batch_);
+}
+
+CodecMemoryUsage AudioEncoderCore::MemoryUsage(size_t instance_size) const
+{
+    CodecMemoryUsage usage;
+    usage.instance = instance_size + (stats_ ? sizeof(CodecStats) : 0U) + (silence_ ? sizeof(SilenceDetector) : 0U);
+    usage.buffers  = input_converter_.MemoryUsage() + frame_pool_->BufferSize(frame_)
+                    + batch_.capacity() * sizeof(EncodedPacket);
+
+    if (fifo_)
+    {
+        usage.buffers += static_cast<size_t>(av_audio_fifo_size(fifo_) + av_audio_fifo_space(fifo_)) * channels_
+                         * av_get_bytes_per_sample(sample_format_);
+    }
+    if (silent_packet_ && silent_packet_->buf)
+    {
+        usage.buffers += silent_packet_->buf->size;
+    }
+
+    return usage;
+}
+
+int AudioEncoderCore::FrameSize() const
+{
+    return codec_context_->frame_size;
+}
+
+uint64_t AudioEncoderCore::SkippedFrames() const
+{
+    return skipped_frames_;
+}
@@ -0,0 +1,284 @@
+#include <file_sink.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+FileSink::FileSink(const std::string& path, size_t buffer_size, bool async_flush, bool append)
+    : fd_(-1)
+    , buffer_size_(buffer_size)
+    , async_flush_(async_flush)
+    , back_pending_(false)
+    , stop_(false)
+    , failed_(false)
+    , bytes_written_(0U)
+{
+    int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC);
+
+    fd_ = open(path.c_str(), flags, 0644);
+    if (fd_ < 0)
+    {
+        throw std::runtime_error("Could not open output file: " + path);
+    }
+
+    front_buffer_.reserve(buffer_size_);
+
+    if (async_flush_)
+    {
+        back_buffer_.reserve(buffer_size_);
+        flush_thread_ = std::thread(&FileSink::FlushThread, this);
+    }
+}
+
+FileSink::~FileSink()
+{
+    Close();
+}
+
+bool FileSink::Write(const uint8_t* data, size_t size)
+{
+    struct iovec iov[1] = {{const_cast<uint8_t*>(data), size}};
+
+    if (async_flush_)
+    {
+        return WriteAsync(iov, 1);
+    }
+
+    return WriteSync(iov, 1, size);
+}
+
+bool FileSink::Write(const uint8_t* header, size_t header_size, const uint8_t* data, size_t data_size)
+{
+    struct iovec iov[2] = {{const_cast<uint8_t*>(header), header_size}, {const_cast<uint8_t*>(data), data_size}};
+
+    if (async_flush_)
+    {
+        return WriteAsync(iov, 2);
+    }
+
+    return WriteSync(iov, 2, header_size + data_size);
+}
+
+bool FileSink::Flush()
+{
+    if (fd_ < 0)
+    {
+        return false;
+    }
+
+    if (async_flush_)
+    {
+        if (!front_buffer_.empty() && !SubmitFrontBuffer())
+        {
+            return false;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this] { return !back_pending_; });
+
+        return !failed_;
+    }
+
+    if (front_buffer_.empty())
+    {
+        return true;
+    }
+
+    struct iovec iov[1] = {{front_buffer_.data(), front_buffer_.size()}};
+    bool         ret    = WriteVector(iov, 1);
+    front_buffer_.clear();
+
+    return ret;
+}
+
+bool FileSink::Close()
+{
+    if (fd_ < 0)
+    {
+        return true;
+    }
+
+    bool ret = Flush();
+
+    if (flush_thread_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cond_.notify_all();
+        flush_thread_.join();
+    }
+
+    if (close(fd_) < 0)
+    {
+        std::cerr << "Failed to close output file: " << strerror(errno) << std::endl;
+        ret = false;
+    }
+    fd_ = -1;
+
+    return ret;
+}
+
+uint64_t FileSink::BytesWritten() const
+{
+    return bytes_written_.load(std::memory_order_relaxed);
+}
+
+bool FileSink::WriteVector(struct iovec* iov, int iovcnt)
+{
+    // writev 可能只写出部分数据，需要推进 iovec 后继续写
+    while (iovcnt > 0)
+    {
+        ssize_t written = writev(fd_, iov, iovcnt);
+        if (written < 0)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+
+            std::cerr << "Failed to write output file: " << strerror(errno) << std::endl;
+            return false;
+        }
+
+        size_t remain = static_cast<size_t>(written);
+        while (iovcnt > 0 && remain >= iov->iov_len)
+        {
+            remain -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+
+        if (iovcnt > 0)
+        {
+            iov->iov_base = static_cast<uint8_t*>(iov->iov_base) + remain;
+            iov->iov_len -= remain;
+        }
+    }
+
+    return true;
+}
+
+bool FileSink::WriteSync(const struct iovec* iov, int iovcnt, size_t total)
+{
+    if (fd_ < 0)
+    {
+        return false;
+    }
+
+    bytes_written_.fetch_add(total, std::memory_order_relaxed);
+
+    // 缓冲区放得下则只做一次拷贝
+    if (front_buffer_.size() + total <= buffer_size_)
+    {
+        for (int i = 0; i < iovcnt; ++i)
+        {
+            const uint8_t* src = static_cast<const uint8_t*>(iov[i].iov_base);
+            front_buffer_.insert(front_buffer_.end(), src, src + iov[i].iov_len);
+        }
+
+        return true;
+    }
+
+    // 放不下时将缓冲区与本次数据合并为一次 writev 调用，避免再次拷贝
+    struct iovec batch[3];
+    int          count = 0;
+
+    if (!front_buffer_.empty())
+    {
+        batch[count++] = {front_buffer_.data(), front_buffer_.size()};
+    }
+
+    for (int i = 0; i < iovcnt; ++i)
+    {
+        batch[count++] = iov[i];
+    }
+
+    bool ret = WriteVector(batch, count);
+    front_buffer_.clear();
+
+    return ret;
+}
+
+bool FileSink::WriteAsync(const struct iovec* iov, int iovcnt)
+{
+    if (fd_ < 0)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < iovcnt; ++i)
+    {
+        const uint8_t* src    = static_cast<const uint8_t*>(iov[i].iov_base);
+        size_t         remain = iov[i].iov_len;
+
+        bytes_written_.fetch_add(remain, std::memory_order_relaxed);
+
+        while (remain > 0)
+        {
+            size_t space = buffer_size_ - front_buffer_.size();
+            size_t bytes = std::min(space, remain);
+
+            front_buffer_.insert(front_buffer_.end(), src, src + bytes);
+            src += bytes;
+            remain -= bytes;
+
+            if (front_buffer_.size() == buffer_size_ && !SubmitFrontBuffer())
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool FileSink::SubmitFrontBuffer()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // 等待后台线程写完上一个缓冲区后交换前后缓冲区
+    cond_.wait(lock, [this] { return !back_pending_; });
+    if (failed_)
+    {
+        return false;
+    }
+
+    front_buffer_.swap(back_buffer_);
+    back_pending_ = true;
+    lock.unlock();
+
+    cond_.notify_all();
+
+    return true;
+}
+
+void FileSink::FlushThread()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true)
+    {
+        cond_.wait(lock, [this] { return back_pending_ || stop_; });
+        if (!back_pending_)
+        {
+            break;
+        }
+
+        // 写出期间 back_buffer_ 由本线程独占，无需持锁
+        lock.unlock();
+        struct iovec iov[1] = {{back_buffer_.data(), back_buffer_.size()}};
+        bool         ret    = WriteVector(iov, 1);
+        lock.lock();
+
+        back_buffer_.clear();
+        back_pending_ = false;
+        failed_       = failed_ || !ret;
+        cond_.notify_all();
+    }
+}
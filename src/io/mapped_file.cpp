@@ -0,0 +1,104 @@
+#include <mapped_file.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string& path, bool sequential)
+    : data_(nullptr)
+    , size_(0U)
+    , mapping_size_(0U)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Could not open input file: " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0)
+    {
+        close(fd);
+        throw std::runtime_error("Could not stat input file: " + path);
+    }
+
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_                = static_cast<size_t>(st.st_size);
+    mapping_size_        = (size_ + kTailPadding + page_size - 1) / page_size * page_size;
+
+    // 先保留一段匿名零页区域，再把文件映射到其起始位置。
+    // 文件末尾之后的字节落在匿名页或文件最后一页的零填充部分，读取时不会触发 SIGBUS
+    void* region = mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == region)
+    {
+        close(fd);
+        throw std::runtime_error("Could not reserve mapping for: " + path);
+    }
+
+    if (size_ > 0 && MAP_FAILED == mmap(region, size_, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0))
+    {
+        munmap(region, mapping_size_);
+        close(fd);
+        throw std::runtime_error("Could not map input file: " + path);
+    }
+    close(fd);
+
+    data_ = static_cast<uint8_t*>(region);
+
+    if (sequential)
+    {
+        Advise(0U, size_, MADV_SEQUENTIAL);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+    {
+        munmap(data_, mapping_size_);
+    }
+}
+
+const uint8_t* MappedFile::Data() const
+{
+    return data_;
+}
+
+size_t MappedFile::Size() const
+{
+    return size_;
+}
+
+void MappedFile::WillNeed(size_t offset, size_t size)
+{
+    Advise(offset, size, MADV_WILLNEED);
+}
+
+void MappedFile::DontNeed(size_t offset, size_t size)
+{
+    Advise(offset, size, MADV_DONTNEED);
+}
+
+void MappedFile::Advise(size_t offset, size_t size, int advice)
+{
+    if (offset >= size_ || 0U == size)
+    {
+        return;
+    }
+
+    // madvise 要求起始地址按页对齐
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t begin     = offset / page_size * page_size;
+    size_t end       = std::min(offset + size, size_);
+
+    if (madvise(data_ + begin, end - begin, advice) < 0)
+    {
+        std::cerr << "madvise failed: " << strerror(errno) << std::endl;
+    }
+}
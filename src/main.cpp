@@ -3,212 +3,289 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <algorithm>
+#include <string>
 
 #include <audio_encoder_aac.h>
 #include <audio_encoder_mp3.h>
 #include <audio_decoder_aac.h>
 #include <audio_decoder_mp3.h>
-
-void SaveAAC(uint8_t* header, uint32_t header_size, uint8_t* data, uint32_t data_size)
-{
-    FILE* file = fopen("output.aac", "ab+");
-    if (!file)
-    {
-        std::cerr << "Failed to open output file" << std::endl;
-        return;
-    }
-
-    fwrite(header, 1, header_size, file);
-    fwrite(data, 1, data_size, file);
-    fclose(file);
-}
-
-void SaveMP3(uint8_t* data, uint32_t data_size)
+#include <file_sink.h>
+#include <parallel_audio_encoder.h>
+#include <parallel_audio_decoder.h>
+#include <mapped_file.h>
+#include <adts_demuxer.h>
+#include <mp3_demuxer.h>
+#include <encoded_packet.h>
+#include <encode_pipeline.h>
+#include <audio_transcoder.h>
+#include <async_codec.h>
+
+// 协程中逐个取出编码数据包写入文件，等待编码期间协程挂起，不占用线程
+template <typename Encoder>
+Task<void> EncodeToSink(AsyncEncoder<Encoder>& encoder, std::span<const uint8_t> pcm, size_t chunk_size,
+                        std::shared_ptr<FileSink> sink)
 {
-    FILE* file = fopen("output.mp3", "ab+");
-    if (!file)
+    AsyncGenerator<EncodedPacket> packets = encoder.Packets(pcm, chunk_size);
+    while (co_await packets.Next())
     {
-        std::cerr << "Failed to open output file" << std::endl;
-        return;
+        const EncodedPacket& packet = packets.Value();
+        sink->Write(packet.Header(), packet.HeaderSize(), packet.Data(), packet.Size());
     }
-
-    fwrite(data, 1, data_size, file);
-    fclose(file);
-}
-
-void SavePCM(std::string filename, uint8_t* data, uint32_t data_size)
-{
-    FILE* file = fopen(filename.c_str(), "ab+");
-    if (!file)
-    {
-        std::cerr << "Failed to open output file" << std::endl;
-        return;
-    }
-
-    fwrite(data, 1, data_size, file);
-    fclose(file);
 }
 
 int main(int argc, char* argv[])
 {
+    // --parallel: 离线批处理模式，整个PCM文件分段后在所有核心上并行编码，AAC/MP3 文件同样分段并行解码
+    // --pipeline: 流水线模式，读取、编码、写出在不同线程上重叠执行
+    // --stream: 推送模式，编码结果按网络报文大小切块送入解码器，由解码器自行分帧
+    // --async: 协程模式，编码在共享线程池上进行，主线程只等待协程结束
+    std::string mode     = argc > 1 ? argv[1] : "";
+    bool        parallel = mode == "--parallel";
+    bool        pipeline = mode == "--pipeline";
+    bool        stream   = mode == "--stream";
+    bool        async    = mode == "--async";
+
     size_t buffer_size =
         1024 * 4 * 2; // 每帧1024个样本，每个样本2个通道，每个通道一个float，一个float4个字节，一共 1024 * 4 * 2 个字节
 
+    // 输出文件只打开一次，数据经用户态缓冲区批量写出
+    std::shared_ptr<FileSink> aac_sink     = std::make_shared<FileSink>("output.aac");
+    std::shared_ptr<FileSink> mp3_sink     = std::make_shared<FileSink>("output.mp3");
+    std::shared_ptr<FileSink> aac_pcm_sink = std::make_shared<FileSink>("aac_f32le_ar44100_ac2.pcm");
+    std::shared_ptr<FileSink> mp3_pcm_sink = std::make_shared<FileSink>("mp3_f32le_ar44100_ac2.pcm");
+
     std::shared_ptr<AudioEncoderAAC> aac_encoder = std::make_shared<AudioEncoderAAC>(80000, 44100, 2);
 
-    aac_encoder->InstallCallback(SaveAAC);
+    // 每次 Encode 产生的数据包一次性批量交付，包数据直接引用编码器输出的缓冲区
+    aac_encoder->InstallBatchCallback([aac_sink](std::vector<EncodedPacket>& packets) {
+        for (const EncodedPacket& packet : packets)
+        {
+            aac_sink->Write(packet.Header(), packet.HeaderSize(), packet.Data(), packet.Size());
+        }
+    });
     std::shared_ptr<AudioEncoderMP3> mp3_encoder = std::make_shared<AudioEncoderMP3>(320000, 44100, 2);
-    mp3_encoder->InstallCallback(SaveMP3);
+    mp3_encoder->InstallCallback([mp3_sink](uint8_t* data, uint32_t data_size) { mp3_sink->Write(data, data_size); });
 
     std::shared_ptr<AudioDecoderAAC> aac_decoder = std::make_shared<AudioDecoderAAC>();
 
-    std::function<void(uint8_t*, uint32_t)> aac_decoder_callback =
-        std::bind(SavePCM, std::string("aac_f32le_ar44100_ac2.pcm"), std::placeholders::_1, std::placeholders::_2);
+    std::function<void(uint8_t*, uint32_t)> aac_decoder_callback = [aac_pcm_sink](uint8_t* data, uint32_t data_size) {
+        aac_pcm_sink->Write(data, data_size);
+    };
     aac_decoder->InstallCallback(aac_decoder_callback);
 
     std::shared_ptr<AudioDecoderMP3> mp3_decoder = std::make_shared<AudioDecoderMP3>();
 
-    std::function<void(uint8_t*, uint32_t)> mp3_decoder_callback =
-        std::bind(SavePCM, std::string("mp3_f32le_ar44100_ac2.pcm"), std::placeholders::_1, std::placeholders::_2);
+    std::function<void(uint8_t*, uint32_t)> mp3_decoder_callback = [mp3_pcm_sink](uint8_t* data, uint32_t data_size) {
+        mp3_pcm_sink->Write(data, data_size);
+    };
     mp3_decoder->InstallCallback(mp3_decoder_callback);
-    std::shared_ptr<uint8_t> data(new uint8_t[buffer_size](), std::default_delete<uint8_t[]>());
 
-    std::ifstream pcm_file("f32le_ar44100_ac2.pcm", std::ios::binary);
-    if (!pcm_file)
+    // 输入文件全部通过内存映射读取，编解码器直接读取映射内的数据
+    std::shared_ptr<MappedFile> pcm_file;
+    try
+    {
+        pcm_file = std::make_shared<MappedFile>("f32le_ar44100_ac2.pcm");
+    }
+    catch (const std::exception& e)
     {
         std::cerr << "Could not open input file" << std::endl;
         return -1;
     }
 
-    while (pcm_file.read(reinterpret_cast<char*>(data.get()), buffer_size))
+    if (parallel)
     {
-        aac_encoder->Encode(data.get(), buffer_size);
-        mp3_encoder->Encode(data.get(), buffer_size);
+        ParallelAudioEncoder parallel_aac_encoder(AudioCodecType::kAAC, 80000, 44100, 2);
+        parallel_aac_encoder.InstallCallback([aac_sink](uint8_t* data, uint32_t data_size) {
+            aac_sink->Write(data, data_size);
+        });
+
+        ParallelAudioEncoder parallel_mp3_encoder(AudioCodecType::kMP3, 320000, 44100, 2);
+        parallel_mp3_encoder.InstallCallback([mp3_sink](uint8_t* data, uint32_t data_size) {
+            mp3_sink->Write(data, data_size);
+        });
+
+        if (!parallel_aac_encoder.Encode(pcm_file->Data(), pcm_file->Size())
+            || !parallel_mp3_encoder.Encode(pcm_file->Data(), pcm_file->Size()))
+        {
+            std::cerr << "Parallel encode failed" << std::endl;
+            return -1;
+        }
     }
-
-    std::ifstream aac_file("output.aac", std::ios::binary);
-    if (!aac_file)
+    else if (pipeline)
     {
-        std::cerr << "Failed to open output.aac for reading" << std::endl;
-        return -1;
-    }
+        // 流水线中的编码器只通过数据包回调输出，由写出线程写入文件
+        EncodePipeline encode_pipeline;
+        encode_pipeline.AddAACStream(std::make_shared<AudioEncoderAAC>(80000, 44100, 2), aac_sink);
+        encode_pipeline.AddMP3Stream(std::make_shared<AudioEncoderMP3>(320000, 44100, 2), mp3_sink);
 
-    while (aac_file)
-    {
-        // 读取帧头（ADTS header）
-        uint8_t adtsHeader[7];
-        aac_file.read(reinterpret_cast<char*>(adtsHeader), sizeof(adtsHeader));
-        if (aac_file.gcount() < sizeof(adtsHeader))
+        if (!encode_pipeline.Run(pcm_file->Data(), pcm_file->Size()))
         {
-            break;
+            std::cerr << "Pipeline encode failed" << std::endl;
+            return -1;
         }
+    }
+    else if (async)
+    {
+        AsyncExecutor                 executor;
+        AsyncEncoder<AudioEncoderAAC> async_aac_encoder(executor, aac_encoder);
+        AsyncEncoder<AudioEncoderMP3> async_mp3_encoder(executor, mp3_encoder);
+        std::span<const uint8_t>      pcm(pcm_file->Data(), pcm_file->Size());
 
-        // 解析帧长度（ADTS header的第3到第5字节包含帧长度信息）
-        int frameLength = ((adtsHeader[3] & 0x03) << 11) | (adtsHeader[4] << 3) | ((adtsHeader[5] & 0xE0) >> 5);
-
-        // 减去ADTS头的长度，得到AAC数据的长度
-        frameLength -= sizeof(adtsHeader);
-
-        // 读取AAC帧数据
-        std::vector<uint8_t> frameData(frameLength);
-        aac_file.read(reinterpret_cast<char*>(frameData.data()), frameLength);
-        if (aac_file.gcount() < frameLength)
+        try
         {
-            break;
+            SyncWait(EncodeToSink(async_aac_encoder, pcm, buffer_size, aac_sink));
+            SyncWait(EncodeToSink(async_mp3_encoder, pcm, buffer_size, mp3_sink));
         }
-
-        // 解码当前AAC帧
-        if (!aac_decoder->Decode(frameData.data(), frameLength))
+        catch (const std::exception& e)
         {
-            std::cerr << "Failed to decode AAC frame" << std::endl;
+            std::cerr << "Async encode failed: " << e.what() << std::endl;
             return -1;
         }
     }
+    else
+    {
+        // 编码器内部带有FIFO，读取块大小无需与编码帧长(AAC 1024 / MP3 1152)一致，文件尾部的不足一块的数据也一并送入
+        for (size_t offset = 0; offset < pcm_file->Size(); offset += buffer_size)
+        {
+            size_t size = std::min(buffer_size, pcm_file->Size() - offset);
+            aac_encoder->Encode(pcm_file->Data() + offset, size);
+            mp3_encoder->Encode(pcm_file->Data() + offset, size);
+        }
+
+        aac_encoder->Flush();
+        mp3_encoder->Flush();
+    }
+
+    // 回读前先将缓冲区中的码流写入文件
+    aac_sink->Close();
+    mp3_sink->Close();
 
-    std::ifstream mp3_file("output.mp3", std::ios::binary);
-    if (!mp3_file)
+    std::shared_ptr<MappedFile> aac_file;
+    std::shared_ptr<MappedFile> mp3_file;
+    try
     {
-        std::cerr << "Failed to open output.mp3 for reading" << std::endl;
+        aac_file = std::make_shared<MappedFile>("output.aac");
+        mp3_file = std::make_shared<MappedFile>("output.mp3");
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Failed to open encoded output for reading: " << e.what() << std::endl;
         return -1;
     }
 
-    std::vector<uint8_t> buffer(4096);
-
-    while (mp3_file)
+    // 转码在内存中完成：解码出的平面帧直接送入另一种编码器，不经过 PCM 文件
+    std::shared_ptr<FileSink> aac_to_mp3_sink = std::make_shared<FileSink>("aac_to_mp3.mp3");
+    std::shared_ptr<FileSink> mp3_to_aac_sink = std::make_shared<FileSink>("mp3_to_aac.aac");
+    AudioTranscoder           aac_to_mp3(AudioCodecType::kAAC, AudioCodecType::kMP3, 320000);
+    AudioTranscoder           mp3_to_aac(AudioCodecType::kMP3, AudioCodecType::kAAC, 80000);
+    aac_to_mp3.InstallPacketCallback([aac_to_mp3_sink](EncodedPacket&& packet) {
+        aac_to_mp3_sink->Write(packet.Data(), packet.Size());
+    });
+    mp3_to_aac.InstallPacketCallback([mp3_to_aac_sink](EncodedPacket&& packet) {
+        mp3_to_aac_sink->Write(packet.Header(), packet.HeaderSize(), packet.Data(), packet.Size());
+    });
+
+    if (parallel)
     {
-        // 读取MP3帧头部（前4个字节用于检测帧同步字）
-        mp3_file.read(reinterpret_cast<char*>(buffer.data()), 4);
-        if (mp3_file.gcount() < 4)
+        ParallelAudioDecoder parallel_aac_decoder;
+        parallel_aac_decoder.InstallCallback(aac_decoder_callback);
+        if (!parallel_aac_decoder.DecodeAdts(aac_file->Data(), aac_file->Size()))
         {
-            break;
+            std::cerr << "Parallel decode failed" << std::endl;
+            return -1;
         }
 
-        // 检查帧同步字 (11个连续的1)
-        if ((buffer[0] == 0xFF) && ((buffer[1] & 0xE0) == 0xE0))
+        ParallelAudioDecoder parallel_mp3_decoder;
+        parallel_mp3_decoder.InstallCallback(mp3_decoder_callback);
+        if (!parallel_mp3_decoder.DecodeMp3(mp3_file->Data(), mp3_file->Size()))
         {
-            // 计算帧比特率
-            int bitrate_index = (buffer[2] >> 4) & 0x0F;
-            int bitrate       = 0;
-
-            static const int bitrates[] = {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0};
-            if (bitrate_index > 0 && bitrate_index < 15)
+            std::cerr << "Parallel decode failed" << std::endl;
+            return -1;
+        }
+    }
+    else if (stream)
+    {
+        // 块大小取 TCP 最大报文段长度，与帧边界无关
+        const size_t chunk_size = 1460;
+        for (size_t offset = 0; offset < aac_file->Size(); offset += chunk_size)
+        {
+            if (!aac_decoder->DecodeStream(aac_file->Data() + offset, std::min(chunk_size, aac_file->Size() - offset)))
             {
-                bitrate = bitrates[bitrate_index] * 1000; // 比特率的单位是kbps
+                std::cerr << "Failed to decode AAC stream" << std::endl;
+                return -1;
             }
-            else
+        }
+
+        for (size_t offset = 0; offset < mp3_file->Size(); offset += chunk_size)
+        {
+            if (!mp3_decoder->DecodeStream(mp3_file->Data() + offset, std::min(chunk_size, mp3_file->Size() - offset)))
             {
-                std::cerr << "Invalid bitrate index: " << bitrate_index << std::endl;
-                break;
+                std::cerr << "Failed to decode MP3 stream" << std::endl;
+                return -1;
             }
+        }
 
-            // 计算采样率
-            int sample_rate_index = (buffer[2] >> 2) & 0x03;
-            int sample_rate       = 0;
+        if (!aac_decoder->FlushStream() || !mp3_decoder->FlushStream())
+        {
+            std::cerr << "Failed to flush stream decoders" << std::endl;
+            return -1;
+        }
+    }
 
-            static const int sample_rates[] = {44100, 48000, 32000, 0};
-            if (sample_rate_index < 3)
-            {
-                sample_rate = sample_rates[sample_rate_index];
-            }
-            else
-            {
-                std::cerr << "Invalid sample rate index: " << sample_rate_index << std::endl;
-                break;
-            }
+    // 扫描一次建立帧索引，逐帧把映射区域内的数据直接送入解码器
+    AdtsDemuxer adts_demuxer(aac_file->Data(), aac_file->Size());
+    for (size_t i = 0; i < adts_demuxer.FrameCount(); ++i)
+    {
+        AdtsFrame frame;
+        adts_demuxer.GetFrame(i, frame);
 
-            // 计算帧长度
-            int padding     = (buffer[2] >> 1) & 0x01;
-            int frameLength = (144 * bitrate / sample_rate) + padding;
+        // 解码当前AAC帧
+        // 传入含 ADTS 头的完整帧，解码器从帧头获取采样率与声道数
+        if (!parallel && !stream && !aac_decoder->Decode(frame.data, frame.size))
+        {
+            std::cerr << "Failed to decode AAC frame" << std::endl;
+            return -1;
+        }
 
-            // 检查帧长度是否有效
-            if (frameLength < 7 || frameLength > 1441)
-            {
-                std::cerr << "Invalid frame length: " << frameLength << std::endl;
-                break;
-            }
+        if (!aac_to_mp3.Transcode(frame.data, frame.size))
+        {
+            std::cerr << "Failed to transcode AAC frame" << std::endl;
+            return -1;
+        }
+    }
 
-            // 读取完整的MP3帧
-            buffer.resize(frameLength);
-            mp3_file.read(reinterpret_cast<char*>(buffer.data() + 4), frameLength - 4);
-            if (mp3_file.gcount() < frameLength - 4)
-            {
-                break;
-            }
+    // 向量化查找同步字并校验相邻帧，支持 MPEG-1/2/2.5 并跳过 ID3 标签
+    Mp3Demuxer mp3_demuxer(mp3_file->Data(), mp3_file->Size());
+    for (size_t i = 0; i < mp3_demuxer.FrameCount(); ++i)
+    {
+        Mp3Frame frame;
+        mp3_demuxer.GetFrame(i, frame);
 
-            // 送入解码器
-            std::cout << "Frame length: " << frameLength << std::endl;
-            if (!mp3_decoder->Decode(buffer.data(), frameLength))
-            {
-                std::cerr << "Failed to decode MP3 frame" << std::endl;
-                return -1;
-            }
+        // 送入解码器
+        if (!parallel && !stream && !mp3_decoder->Decode(frame.data, frame.size))
+        {
+            std::cerr << "Failed to decode MP3 frame" << std::endl;
+            return -1;
         }
-        else
+
+        if (!mp3_to_aac.Transcode(frame.data, frame.size))
         {
-            // 如果未找到帧同步字，则跳过一个字节继续查找
-            mp3_file.seekg(-3, std::ios::cur);
+            std::cerr << "Failed to transcode MP3 frame" << std::endl;
+            return -1;
         }
     }
 
+    if (!aac_to_mp3.Flush() || !mp3_to_aac.Flush())
+    {
+        std::cerr << "Failed to flush transcoders" << std::endl;
+        return -1;
+    }
+
+    aac_pcm_sink->Close();
+    mp3_pcm_sink->Close();
+    aac_to_mp3_sink->Close();
+    mp3_to_aac_sink->Close();
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,266 @@
+#include <multi_rendition_encoder.h>
+#include <audio_encoder_aac.h>
+#include <audio_encoder_mp3.h>
+#include <sample_convert.h>
+
+#include <algorithm>
+
+MultiRenditionEncoder::MultiRenditionEncoder(int sample_rate, int channels, int threads)
+    : sample_rate_(sample_rate)
+    , channels_(channels)
+    , pool_(threads)
+    , remaining_(0U)
+    , started_(false)
+    , flushed_(false)
+    , callback_(nullptr)
+{
+}
+
+MultiRenditionEncoder::~MultiRenditionEncoder()
+{
+    for (ConvertTarget& target : targets_)
+    {
+        if (!target.planes.empty())
+        {
+            av_freep(&target.planes[0]);
+        }
+    }
+}
+
+int MultiRenditionEncoder::AddRendition(AudioCodecType codec, int64_t bitrate)
+{
+    if (started_)
+    {
+        std::cerr << "Renditions must be added before encoding" << std::endl;
+        return -1;
+    }
+
+    Rendition rendition;
+    rendition.codec   = codec;
+    rendition.bitrate = bitrate;
+    rendition.ok      = true;
+
+    int            index  = static_cast<int>(renditions_.size());
+    AVSampleFormat format = AV_SAMPLE_FMT_NONE;
+
+    try
+    {
+        if (AudioCodecType::kAAC == codec)
+        {
+            rendition.aac_encoder = std::make_shared<AudioEncoderAAC>(bitrate, sample_rate_, channels_);
+            rendition.aac_encoder->InstallPacketCallback([this, index](EncodedPacket&& packet) {
+                if (callback_)
+                {
+                    callback_(index, std::move(packet));
+                }
+            });
+            format = AV_SAMPLE_FMT_FLTP;
+        }
+        else
+        {
+            rendition.mp3_encoder = std::make_shared<AudioEncoderMP3>(bitrate, sample_rate_, channels_);
+            rendition.mp3_encoder->InstallPacketCallback([this, index](EncodedPacket&& packet) {
+                if (callback_)
+                {
+                    callback_(index, std::move(packet));
+                }
+            });
+            format = AV_SAMPLE_FMT_S16P;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Could not create rendition: " << e.what() << std::endl;
+        return -1;
+    }
+
+    if (!AddTarget(format, rendition.target))
+    {
+        return -1;
+    }
+
+    renditions_.push_back(rendition);
+
+    return index;
+}
+
+bool MultiRenditionEncoder::AddTarget(AVSampleFormat format, size_t& index)
+{
+    // 相同采样格式的码率共享同一份转换结果
+    for (size_t i = 0; i < targets_.size(); ++i)
+    {
+        if (targets_[i].format == format)
+        {
+            index = i;
+            return true;
+        }
+    }
+
+    ConvertTarget target;
+    target.format = format;
+    target.planes.resize(channels_, nullptr);
+    if (av_samples_alloc(target.planes.data(), nullptr, channels_, kSliceSamples, format, 0) < 0)
+    {
+        std::cerr << "Could not allocate conversion buffer" << std::endl;
+        return false;
+    }
+
+    targets_.push_back(target);
+    index = targets_.size() - 1;
+
+    return true;
+}
+
+bool MultiRenditionEncoder::Encode(const uint8_t* data, size_t size)
+{
+    if (flushed_ || renditions_.empty())
+    {
+        std::cerr << "Encoder has been flushed or has no renditions" << std::endl;
+        return false;
+    }
+    started_ = true;
+
+    size_t frame_bytes = sizeof(float) * channels_;
+
+    // 上次输入末尾不足一个样本帧的字节先与本次开头的字节拼成完整样本帧，单独编码
+    if (!carry_.empty())
+    {
+        size_t used = std::min(frame_bytes - carry_.size(), size);
+        carry_.insert(carry_.end(), data, data + used);
+        data += used;
+        size -= used;
+
+        if (carry_.size() < frame_bytes)
+        {
+            return true;
+        }
+
+        bool ret = EncodeSlice(carry_.data(), 1);
+        carry_.clear();
+        if (!ret)
+        {
+            return false;
+        }
+    }
+
+    size_t total_samples = size / frame_bytes;
+    size_t offset        = 0;
+
+    while (offset < total_samples)
+    {
+        int samples = static_cast<int>(std::min<size_t>(total_samples - offset, kSliceSamples));
+        if (!EncodeSlice(data + offset * frame_bytes, samples))
+        {
+            return false;
+        }
+        offset += samples;
+    }
+
+    // 本次末尾不足一个样本帧的字节留到下次
+    carry_.assign(data + total_samples * frame_bytes, data + size);
+
+    return true;
+}
+
+bool MultiRenditionEncoder::EncodeSlice(const uint8_t* data, int samples)
+{
+    Convert(data, samples);
+
+    // 转换缓冲区在全部码率编码完成前保持不变，各码率只读共享
+    return RunRenditions([this, samples](Rendition& rendition) {
+        const uint8_t* const* planes = targets_[rendition.target].planes.data();
+        return rendition.aac_encoder ? rendition.aac_encoder->EncodePlanar(planes, samples)
+                                     : rendition.mp3_encoder->EncodePlanar(planes, samples);
+    });
+}
+
+bool MultiRenditionEncoder::Flush()
+{
+    if (flushed_)
+    {
+        return true;
+    }
+    flushed_ = true;
+
+    // 输入在样本帧中间结束，剩余字节无法组成样本
+    if (!carry_.empty())
+    {
+        std::cerr << "Discarding " << carry_.size() << " bytes of incomplete sample frame" << std::endl;
+        carry_.clear();
+    }
+
+    return RunRenditions([](Rendition& rendition) {
+        return rendition.aac_encoder ? rendition.aac_encoder->Flush() : rendition.mp3_encoder->Flush();
+    });
+}
+
+void MultiRenditionEncoder::Convert(const uint8_t* data, int samples)
+{
+    // 每种目标格式只转换一次，采样率不变，只做解交错与样本格式转换
+    const float* src = reinterpret_cast<const float*>(data);
+    for (ConvertTarget& target : targets_)
+    {
+        if (AV_SAMPLE_FMT_FLTP == target.format)
+        {
+            DeinterleaveFloat(src, reinterpret_cast<float* const*>(target.planes.data()), channels_, samples);
+        }
+        else
+        {
+            DeinterleaveFloatToS16(src, reinterpret_cast<int16_t* const*>(target.planes.data()), channels_, samples);
+        }
+    }
+}
+
+bool MultiRenditionEncoder::RunRenditions(std::function<bool(Rendition&)> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        remaining_ = renditions_.size();
+    }
+
+    for (Rendition& rendition : renditions_)
+    {
+        Rendition* current = &rendition;
+        pool_.Submit([this, current, &task]() {
+            current->ok = task(*current);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (0 == --remaining_)
+            {
+                cond_.notify_one();
+            }
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this]() { return 0 == remaining_; });
+
+    bool ok = true;
+    for (const Rendition& rendition : renditions_)
+    {
+        if (!rendition.ok)
+        {
+            std::cerr << "Rendition " << rendition.bitrate << " failed" << std::endl;
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+bool MultiRenditionEncoder::InstallCallback(MultiRenditionEncoderCallbackType callback)
+{
+    if (!callback)
+    {
+        return false;
+    }
+
+    callback_ = callback;
+
+    return true;
+}
+
+int MultiRenditionEncoder::RenditionCount() const
+{
+    return static_cast<int>(renditions_.size());
+}
@@ -0,0 +1,324 @@
+#include <parallel_audio_decoder.h>
+#include <audio_decoder_aac.h>
+#include <audio_decoder_mp3.h>
+#include <adts_demuxer.h>
+#include <mp3_demuxer.h>
+
+#include <algorithm>
+#include <thread>
+
+ParallelAudioDecoder::ParallelAudioDecoder(const AudioOutputFormat& output_format, int threads, int preroll_frames)
+    : output_format_(output_format)
+    , threads_(threads)
+    , preroll_frames_(std::max(preroll_frames, 1))
+    , segment_frames_(2048U) // 约47秒，预热开销可以忽略，单个分段的PCM约16MB
+    , next_segment_(0U)
+    , delivered_(0U)
+    , abort_(false)
+    , callback_(nullptr)
+{
+    if (threads_ <= 0)
+    {
+        threads_ = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    // 平面输出引用解码帧本身，无法跨线程暂存；重采样器的状态无法在分段之间衔接
+    if (AudioSampleLayout::kPlanarFloat == output_format_.layout)
+    {
+        throw std::runtime_error("Parallel decode only supports interleaved output");
+    }
+
+    if (output_format_.sample_rate > 0)
+    {
+        throw std::runtime_error("Parallel decode does not support resampling");
+    }
+}
+
+ParallelAudioDecoder::~ParallelAudioDecoder()
+{
+}
+
+bool ParallelAudioDecoder::DecodeAdts(const uint8_t* data, size_t size)
+{
+    AdtsDemuxer demuxer(data, size);
+    if (0 == demuxer.FrameCount())
+    {
+        return true;
+    }
+
+    if (!AdtsSegmentable(demuxer))
+    {
+        return DecodeSerial<AudioDecoderAAC, AdtsFrame>(demuxer);
+    }
+
+    return Run(demuxer.FrameCount(), [this, &demuxer](size_t index, size_t frame_begin, size_t frame_end) {
+        size_t preroll   = static_cast<size_t>(preroll_frames_);
+        size_t pre_begin = (frame_begin > preroll) ? frame_begin - preroll : 0U;
+        DecodeSegment<AudioDecoderAAC, AdtsFrame>(demuxer, index, pre_begin, frame_begin, frame_end);
+    });
+}
+
+bool ParallelAudioDecoder::DecodeMp3(const uint8_t* data, size_t size)
+{
+    Mp3Demuxer demuxer(data, size);
+    if (0 == demuxer.FrameCount())
+    {
+        return true;
+    }
+
+    return Run(demuxer.FrameCount(), [this, &demuxer](size_t index, size_t frame_begin, size_t frame_end) {
+        size_t preroll   = static_cast<size_t>(preroll_frames_);
+        size_t pre_begin = (frame_begin > preroll) ? frame_begin - preroll : 0U;
+
+        // 分段前一帧的主数据可能位于更早的帧中，从其所在帧开始解码才能填满比特池
+        size_t reservoir_start = 0U;
+        if (frame_begin > 0 && demuxer.ReservoirStart(frame_begin - 1, reservoir_start))
+        {
+            pre_begin = std::min(pre_begin, reservoir_start);
+        }
+
+        DecodeSegment<AudioDecoderMP3, Mp3Frame>(demuxer, index, pre_begin, frame_begin, frame_end);
+    });
+}
+
+bool ParallelAudioDecoder::InstallCallback(ParallelAudioDecoderCallbackType callback)
+{
+    if (!callback)
+    {
+        return false;
+    }
+
+    callback_ = callback;
+
+    return true;
+}
+
+bool ParallelAudioDecoder::AdtsSegmentable(const AdtsDemuxer& demuxer) const
+{
+    if (1 != demuxer.Profile())
+    {
+        std::cerr << "AAC profile " << demuxer.Profile() << " is not segmentable, decoding serially" << std::endl;
+        return false;
+    }
+
+    AdtsFrame first;
+    if (!demuxer.GetFrame(0, first))
+    {
+        return false;
+    }
+
+    // 隐式信令的 SBR/PS 在帧头中仍标为 LC，解码首帧后由输出的样本数(SBR 加倍)与声道数(PS 单声道变立体声)识别
+    int  samples  = 0;
+    int  channels = 0;
+    bool decoded  = false;
+    try
+    {
+        AudioDecoderAAC probe(output_format_);
+        probe.InstallFrameCallback([&samples, &channels](const AudioFrameView& view) {
+            samples  = view.nb_samples;
+            channels = view.channels;
+        });
+        decoded = probe.Decode(first.data, first.size);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "AAC probe failed: " << e.what() << std::endl;
+    }
+
+    if (!decoded || samples != static_cast<int>(first.samples) || channels != demuxer.Channels())
+    {
+        std::cerr << "AAC stream uses SBR/PS or could not be probed, decoding serially" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+template <typename Decoder, typename Frame, typename Demuxer>
+bool ParallelAudioDecoder::DecodeSerial(const Demuxer& demuxer)
+{
+    try
+    {
+        Decoder decoder(output_format_);
+        if (callback_)
+        {
+            decoder.InstallCallback(callback_);
+        }
+
+        for (size_t index = 0; index < demuxer.FrameCount(); ++index)
+        {
+            Frame frame;
+            if (!demuxer.GetFrame(index, frame) || !decoder.Decode(frame.data, frame.size))
+            {
+                std::cerr << "Serial decode failed at frame " << index << std::endl;
+                return false;
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Serial decode failed: " << e.what() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool ParallelAudioDecoder::Run(size_t total_frames, const std::function<void(size_t, size_t, size_t)>& decode_segment)
+{
+    size_t segment_count = (total_frames + segment_frames_ - 1) / segment_frames_;
+    size_t window        = static_cast<size_t>(threads_) * 2; // 已解码未输出的分段数上限
+
+    segments_.clear();
+    segments_.resize(segment_count);
+    for (SegmentResult& segment : segments_)
+    {
+        segment.done = false;
+        segment.ok   = false;
+    }
+    next_segment_ = 0U;
+    delivered_    = 0U;
+    abort_        = false;
+
+    auto worker = [&]() {
+        for (;;)
+        {
+            size_t index = 0U;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cond_.wait(lock, [&] {
+                    return abort_ || next_segment_ >= segment_count || next_segment_ < delivered_ + window;
+                });
+                if (abort_ || next_segment_ >= segment_count)
+                {
+                    return;
+                }
+                index = next_segment_++;
+            }
+
+            size_t frame_begin = index * segment_frames_;
+            size_t frame_end   = std::min(frame_begin + segment_frames_, total_frames);
+            decode_segment(index, frame_begin, frame_end);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    size_t                   worker_count = std::min<size_t>(threads_, segment_count);
+    for (size_t i = 0; i < worker_count; ++i)
+    {
+        workers.emplace_back(worker);
+    }
+
+    // 按分段顺序输出，输出后立即释放该分段的内存并允许工作线程继续解码后面的分段
+    bool ret = true;
+    for (size_t index = 0; index < segment_count; ++index)
+    {
+        SegmentResult segment;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_.wait(lock, [this, index] { return segments_[index].done; });
+            segment = std::move(segments_[index]);
+        }
+
+        if (!segment.ok)
+        {
+            ret = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                abort_ = true;
+            }
+            cond_.notify_all();
+            break;
+        }
+
+        if (callback_)
+        {
+            for (size_t i = 0; i < segment.offsets.size(); ++i)
+            {
+                size_t begin = segment.offsets[i];
+                size_t end   = (i + 1 < segment.offsets.size()) ? segment.offsets[i + 1] : segment.bytes.size();
+                callback_(segment.bytes.data() + begin, end - begin);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++delivered_;
+        }
+        cond_.notify_all();
+    }
+
+    for (std::thread& thread : workers)
+    {
+        thread.join();
+    }
+    segments_.clear();
+
+    return ret;
+}
+
+template <typename Decoder, typename Frame, typename Demuxer>
+void ParallelAudioDecoder::DecodeSegment(const Demuxer& demuxer, size_t index, size_t pre_begin, size_t frame_begin,
+                                         size_t frame_end)
+{
+    size_t current = pre_begin;
+
+    SegmentResult result;
+    result.done = true;
+    result.ok   = false;
+
+    // 按分段第一帧的样本数预留输出空间
+    Frame first;
+    if (demuxer.GetFrame(frame_begin, first))
+    {
+        size_t bytes_per_sample = AudioSampleLayout::kInterleavedS16 == output_format_.layout ? 2U : 4U;
+        result.bytes.reserve((frame_end - frame_begin) * first.samples * std::max(demuxer.Channels(), 1)
+                             * bytes_per_sample);
+    }
+    result.offsets.reserve(frame_end - frame_begin);
+
+    try
+    {
+        // 码流参数从每帧的帧头获取，与串行解码使用同样的配置
+        Decoder decoder(output_format_);
+        decoder.InstallCallback([&result, &current, frame_begin](uint8_t* data, uint32_t size) {
+            // 预热帧的输出丢弃
+            if (current < frame_begin)
+            {
+                return;
+            }
+            result.offsets.push_back(result.bytes.size());
+            result.bytes.insert(result.bytes.end(), data, data + size);
+        });
+
+        result.ok = true;
+        for (; current < frame_end && result.ok; ++current)
+        {
+            // 预热帧缺少更早的比特池数据时可能解码出错，与串行解码在码流起点的情况相同，不视为失败
+            Frame frame;
+            result.ok = (demuxer.GetFrame(current, frame) && decoder.Decode(frame.data, frame.size))
+                        || current < frame_begin;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Segment " << index << " decode failed: " << e.what() << std::endl;
+        result.ok = false;
+    }
+
+    if (!result.ok)
+    {
+        std::cerr << "Segment " << index << " failed at frame " << current << std::endl;
+    }
+
+    FinishSegment(index, std::move(result));
+}
+
+void ParallelAudioDecoder::FinishSegment(size_t index, SegmentResult&& result)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        segments_[index] = std::move(result);
+    }
+    cond_.notify_all();
+}
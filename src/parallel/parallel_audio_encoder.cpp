@@ -0,0 +1,209 @@
+#include <parallel_audio_encoder.h>
+#include <audio_encoder_aac.h>
+#include <audio_encoder_mp3.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+ParallelAudioEncoder::ParallelAudioEncoder(AudioCodecType codec, int64_t bitrate, int sample_rate, int channels,
+                                           int threads, int preroll_frames)
+    : codec_(codec)
+    , bitrate_(bitrate)
+    , sample_rate_(sample_rate)
+    , channels_(channels)
+    , threads_(threads)
+    , preroll_frames_(std::max(preroll_frames, 1))
+    , frame_size_(0)
+    , segment_frames_(256U) // 约6秒，保证预热与前瞻的额外开销较小
+    , callback_(nullptr)
+{
+    if (threads_ <= 0)
+    {
+        threads_ = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    // 创建一个探测实例校验参数并获取编码帧长
+    if (AudioCodecType::kAAC == codec_)
+    {
+        AudioEncoderAAC probe(bitrate_, sample_rate_, channels_);
+        frame_size_ = probe.FrameSize();
+    }
+    else
+    {
+        AudioEncoderMP3 probe(bitrate_, sample_rate_, channels_, false);
+        frame_size_ = probe.FrameSize();
+    }
+
+    if (frame_size_ <= 0)
+    {
+        throw std::runtime_error("Encoder does not report a fixed frame size");
+    }
+}
+
+ParallelAudioEncoder::~ParallelAudioEncoder()
+{
+}
+
+bool ParallelAudioEncoder::Encode(const uint8_t* data, size_t size)
+{
+    size_t total_samples = size / (sizeof(float) * channels_);
+    if (0 == total_samples)
+    {
+        return true;
+    }
+
+    size_t total_frames  = (total_samples + frame_size_ - 1) / frame_size_;
+    size_t segment_count = std::max<size_t>(1U, total_frames / segment_frames_);
+    segment_count        = std::min<size_t>(segment_count, static_cast<size_t>(threads_) * 4);
+    size_t frames_per_segment = (total_frames + segment_count - 1) / segment_count;
+    segment_count             = (total_frames + frames_per_segment - 1) / frames_per_segment;
+
+    segments_.clear();
+    segments_.resize(segment_count);
+    for (SegmentResult& segment : segments_)
+    {
+        segment.done = false;
+        segment.ok   = false;
+    }
+
+    std::atomic<size_t> next_segment(0U);
+    std::atomic<bool>   abort(false);
+
+    auto worker = [&]() {
+        while (!abort.load(std::memory_order_relaxed))
+        {
+            size_t index = next_segment.fetch_add(1U);
+            if (index >= segment_count)
+            {
+                break;
+            }
+
+            size_t frame_begin = index * frames_per_segment;
+            size_t frame_end   = std::min(frame_begin + frames_per_segment, total_frames);
+            EncodeSegment(data, total_samples, index, frame_begin, frame_end, index + 1 == segment_count);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    size_t                   worker_count = std::min<size_t>(threads_, segment_count);
+    for (size_t i = 0; i < worker_count; ++i)
+    {
+        workers.emplace_back(worker);
+    }
+
+    // 按分段顺序输出，先完成的分段在此等待，输出后立即释放内存
+    bool ret = true;
+    for (size_t index = 0; index < segment_count; ++index)
+    {
+        SegmentResult segment;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_.wait(lock, [this, index] { return segments_[index].done; });
+            segment = std::move(segments_[index]);
+        }
+
+        if (!segment.ok)
+        {
+            ret = false;
+            abort.store(true, std::memory_order_relaxed);
+            break;
+        }
+
+        if (!callback_)
+        {
+            continue;
+        }
+
+        for (size_t i = segment.first; i < segment.last; ++i)
+        {
+            size_t begin = segment.offsets[i];
+            size_t end   = (i + 1 < segment.offsets.size()) ? segment.offsets[i + 1] : segment.bytes.size();
+            callback_(segment.bytes.data() + begin, end - begin);
+        }
+    }
+
+    for (std::thread& thread : workers)
+    {
+        thread.join();
+    }
+    segments_.clear();
+
+    return ret;
+}
+
+bool ParallelAudioEncoder::InstallCallback(ParallelAudioEncoderCallbackType callback)
+{
+    if (!callback)
+    {
+        return false;
+    }
+
+    callback_ = callback;
+
+    return true;
+}
+
+void ParallelAudioEncoder::EncodeSegment(const uint8_t* data, size_t total_samples, size_t index,
+                                         size_t frame_begin, size_t frame_end, bool last)
+{
+    size_t total_frames = (total_samples + frame_size_ - 1) / frame_size_;
+    size_t pre_begin    = (frame_begin > static_cast<size_t>(preroll_frames_)) ? frame_begin - preroll_frames_ : 0U;
+    size_t post_end     = last ? frame_end : std::min(frame_end + preroll_frames_, total_frames);
+
+    size_t sample_begin = pre_begin * frame_size_;
+    size_t sample_end   = std::min(post_end * frame_size_, total_samples);
+    size_t frame_bytes  = sizeof(float) * channels_;
+
+    const uint8_t* input      = data + sample_begin * frame_bytes;
+    size_t         input_size = (sample_end - sample_begin) * frame_bytes;
+
+    SegmentResult result;
+    result.done = true;
+    result.ok   = false;
+
+    try
+    {
+        if (AudioCodecType::kAAC == codec_)
+        {
+            AudioEncoderAAC encoder(bitrate_, sample_rate_, channels_);
+            encoder.InstallCallback([&result](uint8_t* header, uint32_t header_size, uint8_t* payload,
+                                              uint32_t payload_size) {
+                result.offsets.push_back(result.bytes.size());
+                result.bytes.insert(result.bytes.end(), header, header + header_size);
+                result.bytes.insert(result.bytes.end(), payload, payload + payload_size);
+            });
+            result.ok = encoder.Encode(input, input_size) && encoder.Flush();
+        }
+        else
+        {
+            AudioEncoderMP3 encoder(bitrate_, sample_rate_, channels_, false);
+            encoder.InstallCallback([&result](uint8_t* payload, uint32_t payload_size) {
+                result.offsets.push_back(result.bytes.size());
+                result.bytes.insert(result.bytes.end(), payload, payload + payload_size);
+            });
+            result.ok = encoder.Encode(input, input_size) && encoder.Flush();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Segment " << index << " encode failed: " << e.what() << std::endl;
+        result.ok = false;
+    }
+
+    // 第 k 个数据包对应串行编码的第 pre_begin + k 个数据包，只保留属于本分段的部分；
+    // 最后一个分段保留编码器排空时输出的全部尾部数据包
+    result.first = frame_begin - pre_begin;
+    result.last  = last ? result.offsets.size() : result.first + (frame_end - frame_begin);
+    if (result.last > result.offsets.size() || result.first > result.last)
+    {
+        std::cerr << "Segment " << index << " produced too few packets" << std::endl;
+        result.ok = false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        segments_[index] = std::move(result);
+    }
+    cond_.notify_all();
+}
@@ -0,0 +1,250 @@
+#include <encode_pipeline.h>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+EncodePipeline::EncodePipeline(size_t chunk_size, size_t input_slots, size_t packet_slots)
+    : chunk_size_(chunk_size > 0 ? chunk_size : kDefaultChunkSize)
+    , input_slots_(input_slots)
+    , packet_slots_(packet_slots)
+    , failed_(false)
+    , ran_(false)
+{
+}
+
+EncodePipeline::~EncodePipeline()
+{
+    ClearCallbacks();
+}
+
+bool EncodePipeline::AddAACStream(std::shared_ptr<AudioEncoderAAC> encoder, std::shared_ptr<FileSink> sink)
+{
+    if (!encoder || !sink || ran_)
+    {
+        return false;
+    }
+
+    Stream* stream      = AddStream("aac", sink);
+    stream->aac_encoder = encoder;
+    stream->encode = [encoder](const uint8_t* data, size_t size) { return encoder->Encode(data, size); };
+    stream->flush  = [encoder]() { return encoder->Flush(); };
+
+    // 数据包在编码线程中产生，直接移入该路的输出队列
+    return encoder->InstallPacketCallback(
+        [this, stream](EncodedPacket&& packet) { PushPacket(stream, std::move(packet)); });
+}
+
+bool EncodePipeline::AddMP3Stream(std::shared_ptr<AudioEncoderMP3> encoder, std::shared_ptr<FileSink> sink)
+{
+    if (!encoder || !sink || ran_)
+    {
+        return false;
+    }
+
+    Stream* stream      = AddStream("mp3", sink);
+    stream->mp3_encoder = encoder;
+    stream->encode = [encoder](const uint8_t* data, size_t size) { return encoder->Encode(data, size); };
+    stream->flush  = [encoder]() { return encoder->Flush(); };
+
+    return encoder->InstallPacketCallback(
+        [this, stream](EncodedPacket&& packet) { PushPacket(stream, std::move(packet)); });
+}
+
+EncodePipeline::Stream* EncodePipeline::AddStream(const std::string& name, std::shared_ptr<FileSink> sink)
+{
+    // 输入槽位预先分配 chunk_size_ 字节，运行时只做拷贝
+    PcmChunk prototype;
+    prototype.data.resize(chunk_size_);
+    prototype.size = 0;
+
+    std::unique_ptr<Stream> stream(new Stream());
+    stream->name    = name;
+    stream->sink    = sink;
+    stream->input   = std::unique_ptr<SpscRing<PcmChunk>>(new SpscRing<PcmChunk>(input_slots_, prototype));
+    stream->packets = std::unique_ptr<SpscRing<EncodedPacket>>(new SpscRing<EncodedPacket>(packet_slots_));
+
+    streams_.push_back(std::move(stream));
+
+    return streams_.back().get();
+}
+
+bool EncodePipeline::Run(const uint8_t* data, size_t size)
+{
+    if (ran_ || streams_.empty())
+    {
+        std::cerr << "Pipeline has no streams or has already run" << std::endl;
+        return false;
+    }
+    ran_ = true;
+
+    std::vector<std::thread> encode_threads;
+    for (std::unique_ptr<Stream>& stream : streams_)
+    {
+        encode_threads.emplace_back(&EncodePipeline::EncodeStage, this, stream.get());
+    }
+    std::thread write_thread(&EncodePipeline::WriteStage, this);
+
+    ReadStage(data, size);
+
+    for (std::thread& thread : encode_threads)
+    {
+        thread.join();
+    }
+    write_thread.join();
+
+    // 流水线只运行一次，编码器不再需要向本对象交付数据包
+    ClearCallbacks();
+
+    return !failed_.load();
+}
+
+bool EncodePipeline::ReadStage(const uint8_t* data, size_t size)
+{
+    // 输入为内存映射时，首次拷贝触发的缺页读盘发生在本线程，与编码线程重叠
+    for (size_t offset = 0; offset < size; offset += chunk_size_)
+    {
+        size_t chunk_size = std::min(chunk_size_, size - offset);
+
+        for (std::unique_ptr<Stream>& stream : streams_)
+        {
+            PcmChunk* chunk = stream->input->WaitWrite();
+            if (!chunk)
+            {
+                return false;
+            }
+
+            memcpy(chunk->data.data(), data + offset, chunk_size);
+            chunk->size = chunk_size;
+            stream->input->CommitWrite();
+        }
+    }
+
+    for (std::unique_ptr<Stream>& stream : streams_)
+    {
+        stream->input->Close();
+    }
+
+    return true;
+}
+
+void EncodePipeline::EncodeStage(Stream* stream)
+{
+    while (PcmChunk* chunk = stream->input->WaitRead())
+    {
+        bool ret = stream->encode(chunk->data.data(), chunk->size);
+        stream->input->CommitRead();
+
+        if (!ret)
+        {
+            std::cerr << "Pipeline " << stream->name << " encode failed" << std::endl;
+            Cancel();
+            return;
+        }
+    }
+
+    if (stream->input->Cancelled())
+    {
+        return;
+    }
+
+    if (!stream->flush())
+    {
+        std::cerr << "Pipeline " << stream->name << " flush failed" << std::endl;
+        Cancel();
+        return;
+    }
+
+    stream->packets->Close();
+}
+
+void EncodePipeline::PushPacket(Stream* stream, EncodedPacket&& packet)
+{
+    // 写出跟不上时在此等待，编码线程随之减速，队列长度与延迟保持有界
+    EncodedPacket* slot = stream->packets->WaitWrite();
+    if (!slot)
+    {
+        return;
+    }
+
+    *slot = std::move(packet);
+    stream->packets->CommitWrite();
+}
+
+void EncodePipeline::WriteStage()
+{
+    // 单个写出线程轮询各路输出队列，每路队列只有这一个消费者
+    for (unsigned spins = 0;;)
+    {
+        bool   progress = false;
+        size_t finished = 0;
+
+        for (std::unique_ptr<Stream>& stream : streams_)
+        {
+            if (stream->packets->Cancelled())
+            {
+                return;
+            }
+
+            EncodedPacket* packet = stream->packets->AcquireRead();
+            if (!packet)
+            {
+                finished += stream->packets->Finished() ? 1 : 0;
+                continue;
+            }
+
+            bool ret = packet->HeaderSize() > 0
+                           ? stream->sink->Write(packet->Header(), packet->HeaderSize(), packet->Data(), packet->Size())
+                           : stream->sink->Write(packet->Data(), packet->Size());
+
+            // 释放槽位中数据包的引用，缓冲区归还编码器
+            *packet = EncodedPacket();
+            stream->packets->CommitRead();
+            progress = true;
+
+            if (!ret)
+            {
+                std::cerr << "Pipeline " << stream->name << " write failed" << std::endl;
+                Cancel();
+                return;
+            }
+        }
+
+        if (finished == streams_.size())
+        {
+            break;
+        }
+
+        spins = progress ? 0 : spins + 1;
+        if (!progress)
+        {
+            SpscRing<EncodedPacket>::Backoff(spins);
+        }
+    }
+}
+
+void EncodePipeline::ClearCallbacks()
+{
+    for (std::unique_ptr<Stream>& stream : streams_)
+    {
+        if (stream->aac_encoder)
+        {
+            stream->aac_encoder->ClearCallbacks();
+        }
+        if (stream->mp3_encoder)
+        {
+            stream->mp3_encoder->ClearCallbacks();
+        }
+    }
+}
+
+void EncodePipeline::Cancel()
+{
+    failed_.store(true);
+
+    for (std::unique_ptr<Stream>& stream : streams_)
+    {
+        stream->input->Cancel();
+        stream->packets->Cancel();
+    }
+}
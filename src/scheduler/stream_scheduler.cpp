@@ -0,0 +1,264 @@
+#include <stream_scheduler.h>
+#include <audio_encoder_aac.h>
+#include <audio_encoder_mp3.h>
+#include <audio_decoder_aac.h>
+#include <audio_decoder_mp3.h>
+
+StreamScheduler::StreamScheduler(int threads)
+    : next_stream_id_(0)
+    , active_streams_(0U)
+    , pool_(threads)
+{
+}
+
+StreamScheduler::~StreamScheduler()
+{
+    WaitIdle();
+}
+
+int StreamScheduler::AddAACEncoderStream(int64_t bitrate, int sample_rate, int channels,
+                                         AACEncoderCallbackType callback)
+{
+    std::shared_ptr<AudioEncoderAAC> encoder = std::make_shared<AudioEncoderAAC>(bitrate, sample_rate, channels);
+    encoder->InstallCallback(callback);
+
+    std::shared_ptr<Stream> stream = std::make_shared<Stream>();
+    stream->codec                  = encoder;
+    stream->process = [encoder](const uint8_t* data, size_t size) { return encoder->Encode(data, size); };
+    stream->flush   = [encoder]() { return encoder->Flush(); };
+
+    return AddStream(stream);
+}
+
+int StreamScheduler::AddMP3EncoderStream(int64_t bitrate, int sample_rate, int channels,
+                                         MP3EncoderCallbackType callback)
+{
+    std::shared_ptr<AudioEncoderMP3> encoder = std::make_shared<AudioEncoderMP3>(bitrate, sample_rate, channels);
+    encoder->InstallCallback(callback);
+
+    std::shared_ptr<Stream> stream = std::make_shared<Stream>();
+    stream->codec                  = encoder;
+    stream->process = [encoder](const uint8_t* data, size_t size) { return encoder->Encode(data, size); };
+    stream->flush   = [encoder]() { return encoder->Flush(); };
+
+    return AddStream(stream);
+}
+
+int StreamScheduler::AddAACDecoderStream(DecoderCallbackType callback)
+{
+    std::shared_ptr<AudioDecoderAAC> decoder = std::make_shared<AudioDecoderAAC>();
+    decoder->InstallCallback(callback);
+
+    std::shared_ptr<Stream> stream = std::make_shared<Stream>();
+    stream->codec                  = decoder;
+    stream->process = [decoder](const uint8_t* data, size_t size) { return decoder->Decode(data, size); };
+    stream->flush   = [decoder]() { return decoder->FlushStream(); };
+
+    return AddStream(stream);
+}
+
+int StreamScheduler::AddMP3DecoderStream(DecoderCallbackType callback)
+{
+    std::shared_ptr<AudioDecoderMP3> decoder = std::make_shared<AudioDecoderMP3>();
+    decoder->InstallCallback(callback);
+
+    std::shared_ptr<Stream> stream = std::make_shared<Stream>();
+    stream->codec                  = decoder;
+    stream->process = [decoder](const uint8_t* data, size_t size) { return decoder->Decode(data, size); };
+    stream->flush   = [decoder]() { return decoder->FlushStream(); };
+
+    return AddStream(stream);
+}
+
+bool StreamScheduler::Push(int stream_id, const uint8_t* data, size_t size)
+{
+    return Push(stream_id, std::vector<uint8_t>(data, data + size));
+}
+
+bool StreamScheduler::Push(int stream_id, std::vector<uint8_t>&& chunk)
+{
+    std::shared_ptr<Stream> stream = FindStream(stream_id);
+    if (!stream)
+    {
+        std::cerr << "Stream " << stream_id << " not found" << std::endl;
+        return false;
+    }
+
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        if (stream->closing)
+        {
+            std::cerr << "Stream " << stream_id << " is closing" << std::endl;
+            return false;
+        }
+
+        stream->queued_bytes += chunk.size();
+        stream->queue.push_back(std::move(chunk));
+
+        // 流未在执行时才提交任务，保证同一路流不会被多个线程同时处理
+        schedule          = !stream->scheduled;
+        stream->scheduled = true;
+    }
+
+    if (schedule)
+    {
+        Schedule(stream_id, stream);
+    }
+
+    return true;
+}
+
+bool StreamScheduler::CloseStream(int stream_id)
+{
+    std::shared_ptr<Stream> stream = FindStream(stream_id);
+    if (!stream)
+    {
+        return false;
+    }
+
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        stream->closing   = true;
+        schedule          = !stream->scheduled;
+        stream->scheduled = true;
+    }
+
+    if (schedule)
+    {
+        Schedule(stream_id, stream);
+    }
+
+    return true;
+}
+
+bool StreamScheduler::GetBacklog(int stream_id, StreamBacklog& backlog)
+{
+    std::shared_ptr<Stream> stream = FindStream(stream_id);
+    if (!stream)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(stream->mutex);
+    backlog.queued_chunks    = stream->queue.size();
+    backlog.queued_bytes     = stream->queued_bytes;
+    backlog.processed_chunks = stream->processed_chunks.load(std::memory_order_relaxed);
+    backlog.errors           = stream->errors.load(std::memory_order_relaxed);
+
+    return true;
+}
+
+void StreamScheduler::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    idle_cond_.wait(lock, [this] { return 0U == active_streams_; });
+}
+
+int StreamScheduler::AddStream(std::shared_ptr<Stream> stream)
+{
+    stream->queued_bytes = 0U;
+    stream->scheduled    = false;
+    stream->closing      = false;
+    stream->processed_chunks.store(0U);
+    stream->errors.store(0U);
+
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+    int                         stream_id = next_stream_id_++;
+    streams_[stream_id]                   = stream;
+
+    return stream_id;
+}
+
+std::shared_ptr<StreamScheduler::Stream> StreamScheduler::FindStream(int stream_id)
+{
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+    auto                        it = streams_.find(stream_id);
+
+    return (it != streams_.end()) ? it->second : nullptr;
+}
+
+void StreamScheduler::Schedule(int stream_id, const std::shared_ptr<Stream>& stream, bool yield)
+{
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        ++active_streams_;
+    }
+
+    if (yield)
+    {
+        pool_.Yield([this, stream_id, stream]() { RunStream(stream_id, stream); });
+    }
+    else
+    {
+        pool_.Submit([this, stream_id, stream]() { RunStream(stream_id, stream); });
+    }
+}
+
+void StreamScheduler::RunStream(int stream_id, std::shared_ptr<Stream> stream)
+{
+    bool finished = false;
+
+    for (size_t i = 0; i < kBatchChunks; ++i)
+    {
+        std::vector<uint8_t> chunk;
+        {
+            std::lock_guard<std::mutex> lock(stream->mutex);
+            if (stream->queue.empty())
+            {
+                break;
+            }
+
+            chunk = std::move(stream->queue.front());
+            stream->queue.pop_front();
+            stream->queued_bytes -= chunk.size();
+        }
+
+        if (!stream->process(chunk.data(), chunk.size()))
+        {
+            stream->errors.fetch_add(1U, std::memory_order_relaxed);
+        }
+        stream->processed_chunks.fetch_add(1U, std::memory_order_relaxed);
+    }
+
+    bool reschedule = false;
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        if (!stream->queue.empty())
+        {
+            // 仍有积压则重新入队到队列头部，排在本线程已有的其他流之后执行
+            reschedule = true;
+        }
+        else if (stream->closing)
+        {
+            finished = true;
+        }
+        else
+        {
+            stream->scheduled = false;
+        }
+    }
+
+    if (finished)
+    {
+        if (!stream->flush())
+        {
+            stream->errors.fetch_add(1U, std::memory_order_relaxed);
+        }
+
+        std::lock_guard<std::mutex> lock(streams_mutex_);
+        streams_.erase(stream_id);
+    }
+
+    if (reschedule)
+    {
+        Schedule(stream_id, stream, true);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        --active_streams_;
+    }
+    idle_cond_.notify_all();
+}
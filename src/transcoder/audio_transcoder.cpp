@@ -0,0 +1,188 @@
+#include <audio_transcoder.h>
+
+#include <sample_convert.h>
+
+AudioTranscoder::AudioTranscoder(AudioCodecType source, AudioCodecType target, int64_t bitrate, int source_sample_rate,
+                                 int source_channels)
+    : source_(source)
+    , target_(target)
+    , bitrate_(bitrate)
+    , sample_rate_(0)
+    , channels_(0)
+    , failed_(false)
+    , flushed_(false)
+    , aac_decoder_(nullptr)
+    , mp3_decoder_(nullptr)
+    , aac_encoder_(nullptr)
+    , mp3_encoder_(nullptr)
+    , callback_(nullptr)
+{
+    // 解码器输出编码器可直接使用的平面浮点，平面输出引用解码帧本身，不做拷贝
+    AudioOutputFormat output_format;
+    output_format.layout = AudioSampleLayout::kPlanarFloat;
+
+    auto on_frame = [this](const AudioFrameView& frame) {
+        if (!failed_ && !EncodeFrame(frame))
+        {
+            failed_ = true;
+        }
+    };
+
+    if (AudioCodecType::kAAC == source_)
+    {
+        aac_decoder_.reset(new AudioDecoderAAC(output_format, source_sample_rate, source_channels));
+        aac_decoder_->InstallFrameCallback(on_frame);
+    }
+    else
+    {
+        mp3_decoder_.reset(new AudioDecoderMP3(output_format));
+        mp3_decoder_->InstallFrameCallback(on_frame);
+    }
+}
+
+AudioTranscoder::~AudioTranscoder()
+{
+}
+
+bool AudioTranscoder::Transcode(const uint8_t* data, size_t size)
+{
+    if (flushed_)
+    {
+        std::cerr << "Transcoder has been flushed" << std::endl;
+        return false;
+    }
+
+    bool ret = aac_decoder_ ? aac_decoder_->Decode(data, size) : mp3_decoder_->Decode(data, size);
+    if (failed_)
+    {
+        failed_ = false;
+        return false;
+    }
+
+    return ret;
+}
+
+bool AudioTranscoder::Flush()
+{
+    if (flushed_)
+    {
+        return true;
+    }
+    flushed_ = true;
+
+    // 先排空解码器与重采样器，剩余样本经帧回调送入编码器
+    bool drained = aac_decoder_ ? aac_decoder_->FlushStream() : mp3_decoder_->FlushStream();
+    if (failed_)
+    {
+        failed_ = false;
+        drained = false;
+    }
+
+    // 没有解码出任何帧时编码器尚未创建，无数据可排空
+    if (aac_encoder_)
+    {
+        return aac_encoder_->Flush() && drained;
+    }
+    if (mp3_encoder_)
+    {
+        return mp3_encoder_->Flush() && drained;
+    }
+
+    return drained;
+}
+
+bool AudioTranscoder::InstallPacketCallback(AudioTranscoderPacketCallbackType callback)
+{
+    if (!callback)
+    {
+        return false;
+    }
+
+    callback_ = callback;
+
+    return true;
+}
+
+int AudioTranscoder::SampleRate() const
+{
+    return sample_rate_;
+}
+
+int AudioTranscoder::Channels() const
+{
+    return channels_;
+}
+
+bool AudioTranscoder::EncodeFrame(const AudioFrameView& frame)
+{
+    if (0 == sample_rate_)
+    {
+        if (!CreateEncoder(frame.sample_rate, frame.channels))
+        {
+            return false;
+        }
+    }
+    else if (frame.sample_rate != sample_rate_ || frame.channels != channels_)
+    {
+        std::cerr << "Stream parameters changed during transcoding" << std::endl;
+        return false;
+    }
+
+    if (aac_encoder_)
+    {
+        return aac_encoder_->EncodePlanar(frame.data, frame.nb_samples);
+    }
+
+    // MP3 编码器的原生格式为 S16P，逐平面转换，仍不经过交错
+    size_t samples = static_cast<size_t>(frame.nb_samples);
+    if (s16_buffer_.size() < samples * channels_)
+    {
+        s16_buffer_.resize(samples * channels_);
+    }
+
+    for (int ch = 0; ch < channels_; ++ch)
+    {
+        int16_t* plane = s16_buffer_.data() + samples * ch;
+        ConvertFloatToS16(reinterpret_cast<const float*>(frame.data[ch]), plane, frame.nb_samples);
+        s16_planes_[ch] = reinterpret_cast<uint8_t*>(plane);
+    }
+
+    return mp3_encoder_->EncodePlanar(s16_planes_.data(), frame.nb_samples);
+}
+
+bool AudioTranscoder::CreateEncoder(int sample_rate, int channels)
+{
+    try
+    {
+        if (AudioCodecType::kAAC == target_)
+        {
+            aac_encoder_.reset(new AudioEncoderAAC(bitrate_, sample_rate, channels));
+            aac_encoder_->InstallPacketCallback([this](EncodedPacket&& packet) { DeliverPacket(std::move(packet)); });
+        }
+        else
+        {
+            mp3_encoder_.reset(new AudioEncoderMP3(bitrate_, sample_rate, channels));
+            mp3_encoder_->InstallPacketCallback([this](EncodedPacket&& packet) { DeliverPacket(std::move(packet)); });
+            s16_planes_.resize(channels, nullptr);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Could not create encoder for " << sample_rate << "Hz " << channels << "ch: " << e.what()
+                  << std::endl;
+        return false;
+    }
+
+    sample_rate_ = sample_rate;
+    channels_    = channels;
+
+    return true;
+}
+
+void AudioTranscoder::DeliverPacket(EncodedPacket&& packet)
+{
+    if (callback_)
+    {
+        callback_(std::move(packet));
+    }
+}
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <vector>
+#include <mutex>
+#include <future>
+#include <algorithm>
+
+#include <async_executor.h>
+
+// 串行序列公平性测试：单线程执行器上两个积压的序列应按批次交替执行，
+// 任何一个序列连续执行的工作数不超过一批(AsyncStrand 每次调度最多执行 8 个工作)
+namespace
+{
+constexpr size_t kTasksPerStrand = 64U;
+constexpr size_t kBatchTasks     = 8U;
+} // namespace
+
+int main()
+{
+    std::vector<int> order;
+    std::mutex       order_mutex;
+
+    // 先占住唯一的线程，两个序列的工作全部投递后再放行，保证两者同时积压
+    std::promise<void>       gate;
+    std::shared_future<void> opened = gate.get_future().share();
+
+    {
+        AsyncExecutor executor(1);
+        AsyncStrand   strands[2] = {AsyncStrand(executor), AsyncStrand(executor)};
+
+        executor.Submit([opened]() { opened.wait(); });
+
+        for (size_t i = 0; i < kTasksPerStrand; ++i)
+        {
+            for (int id = 0; id < 2; ++id)
+            {
+                strands[id].Post([id, &order, &order_mutex]() {
+                    std::lock_guard<std::mutex> lock(order_mutex);
+                    order.push_back(id);
+                });
+            }
+        }
+
+        gate.set_value();
+    } // 执行器析构时等待全部工作完成
+
+    if (order.size() != kTasksPerStrand * 2)
+    {
+        std::cerr << "Expected " << kTasksPerStrand * 2 << " tasks, ran " << order.size() << std::endl;
+        return 1;
+    }
+
+    size_t longest = 0;
+    size_t run     = 0;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        run     = (i > 0 && order[i] == order[i - 1]) ? run + 1 : 1;
+        longest = std::max(longest, run);
+    }
+
+    if (longest > kBatchTasks)
+    {
+        std::cerr << "Strand ran " << longest << " tasks in a row, expected at most " << kBatchTasks << std::endl;
+        return 1;
+    }
+
+    std::cout << "async_strand_test: ok, longest run " << longest << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include <audio_encoder_aac.h>
+#include <audio_encoder_mp3.h>
+#include <signal_generator.h>
+
+// 静音跳帧测试：有声/静音/有声三段输入(均按帧对齐)，对 AAC 与 MP3 分别以 kOff 为基准检查 kCachedFrame 与 kGap：
+// 数据包数、时间戳从 -initial_padding 起连续递增、静音区间与数据包首尾相接且落在输入的静音段内、SkippedFrames()，
+// 以及 kCachedFrame 下 MP3 关闭比特池(每帧 main_data_begin 为 0)。挂起帧数取下限 2 与默认值 4
+namespace
+{
+constexpr int kSampleRate   = 44100;
+constexpr int kChannels     = 2;
+constexpr int kToneFrames   = 20; // 前后两段有声部分各自的帧数
+constexpr int kSilentFrames = 30;
+
+// 按回调顺序记录的一个输出事件：数据包或静音区间
+struct OutputEvent
+{
+    bool    gap;
+    int64_t pts;
+    int64_t duration;
+};
+
+struct EncodeResult
+{
+    int                               frame_size = 0;
+    size_t                            packets    = 0;
+    uint64_t                          skipped    = 0;
+    std::vector<OutputEvent>          events;
+    std::vector<std::vector<uint8_t>> payloads;
+};
+
+// MP3 帧侧信息开头的 main_data_begin，即本帧借用比特池的字节数
+int Mp3MainDataBegin(const std::vector<uint8_t>& frame)
+{
+    if (frame.size() < 7U || 0xFF != frame[0] || 0xE0 != (frame[1] & 0xE0))
+    {
+        return -1;
+    }
+
+    bool   mpeg1  = 0x18 == (frame[1] & 0x18);
+    size_t offset = (frame[1] & 0x01) ? 4U : 6U; // 无 CRC 时侧信息紧跟 4 字节帧头
+    if (mpeg1)
+    {
+        return (frame[offset] << 1) | (frame[offset + 1] >> 7);
+    }
+    return frame[offset];
+}
+
+template <typename Encoder>
+bool Encode(SilenceMode mode, int hangover, EncodeResult& result)
+{
+    SilenceConfig silence;
+    silence.mode            = mode;
+    silence.hangover_frames = hangover;
+
+    Encoder encoder(128000, kSampleRate, kChannels, true, AudioInputFormat(), silence);
+    result.frame_size = encoder.FrameSize();
+    encoder.InstallPacketCallback([&result](EncodedPacket&& packet) {
+        ++result.packets;
+        result.events.push_back({false, packet.Pts(), packet.Duration()});
+        result.payloads.emplace_back(packet.Data(), packet.Data() + packet.Size());
+    });
+    encoder.InstallGapCallback([&result](int64_t pts, int64_t samples) {
+        result.events.push_back({true, pts, samples});
+    });
+
+    size_t             tone_samples = static_cast<size_t>(kToneFrames) * result.frame_size;
+    size_t             gap_samples  = static_cast<size_t>(kSilentFrames) * result.frame_size;
+    std::vector<float> tone         = GenerateSignal(SignalType::kSine, kSampleRate, kChannels, tone_samples);
+    std::vector<float> pcm(tone);
+    pcm.resize(pcm.size() + gap_samples * kChannels, 0.0f);
+    pcm.insert(pcm.end(), tone.begin(), tone.end());
+
+    if (!encoder.Encode(reinterpret_cast<const uint8_t*>(pcm.data()), pcm.size() * sizeof(float)) || !encoder.Flush())
+    {
+        return false;
+    }
+    result.skipped = encoder.SkippedFrames();
+
+    return true;
+}
+
+bool Fail(const std::string& name, const std::string& message)
+{
+    std::cerr << name << ": " << message << std::endl;
+    return false;
+}
+
+// 检查开启静音检测后的输出，baseline 为同一输入 kOff 的结果
+bool Check(const std::string& name, SilenceMode mode, int hangover, const EncodeResult& baseline,
+           const EncodeResult& result, bool mp3)
+{
+    int64_t  frame_size = result.frame_size;
+    uint64_t expected   = static_cast<uint64_t>(kSilentFrames - hangover);
+    if (result.skipped != expected)
+    {
+        return Fail(name, "skipped " + std::to_string(result.skipped) + " frames, expected " + std::to_string(expected));
+    }
+    if (result.events.empty() || baseline.events.empty())
+    {
+        return Fail(name, "no output");
+    }
+
+    // 时间戳从 kOff 下编码器给出的 -initial_padding 开始，数据包与静音区间首尾相接
+    int64_t next = baseline.events.front().pts;
+    if (next >= 0)
+    {
+        return Fail(name, "first pts " + std::to_string(next) + " does not include the encoder padding");
+    }
+    int64_t gap_samples = 0;
+    for (const OutputEvent& event : result.events)
+    {
+        if (event.pts != next)
+        {
+            return Fail(name, "pts " + std::to_string(event.pts) + ", expected " + std::to_string(next));
+        }
+        next += event.duration > 0 ? event.duration : frame_size;
+
+        if (!event.gap)
+        {
+            continue;
+        }
+        // 静音区间必须落在输入的静音段内：挂起帧数不足时编码器中缓存的有声帧会被跳过的帧顶替
+        gap_samples += event.duration;
+        if (event.pts < kToneFrames * frame_size || next > (kToneFrames + kSilentFrames) * frame_size)
+        {
+            return Fail(name, "gap [" + std::to_string(event.pts) + ", " + std::to_string(next)
+                                  + ") outside the silent input");
+        }
+    }
+
+    if (SilenceMode::kCachedFrame == mode)
+    {
+        if (gap_samples > 0 || result.packets != baseline.packets)
+        {
+            return Fail(name, std::to_string(result.packets) + " packets, expected " + std::to_string(baseline.packets));
+        }
+        for (size_t i = 0; mp3 && i < result.payloads.size(); ++i)
+        {
+            if (0 != Mp3MainDataBegin(result.payloads[i]))
+            {
+                return Fail(name, "packet " + std::to_string(i) + " uses the bit reservoir");
+            }
+        }
+    }
+    else
+    {
+        if (gap_samples != static_cast<int64_t>(result.skipped) * frame_size)
+        {
+            return Fail(name, "gaps cover " + std::to_string(gap_samples) + " samples, expected "
+                                  + std::to_string(result.skipped * frame_size));
+        }
+        if (result.packets + result.skipped != baseline.packets)
+        {
+            return Fail(name, std::to_string(result.packets) + " packets and " + std::to_string(result.skipped)
+                                  + " gaps, expected " + std::to_string(baseline.packets) + " frames");
+        }
+    }
+
+    return true;
+}
+
+template <typename Encoder>
+bool Run(const std::string& codec, bool mp3)
+{
+    EncodeResult baseline;
+    if (!Encode<Encoder>(SilenceMode::kOff, 4, baseline))
+    {
+        return Fail(codec, "failed to encode without silence detection");
+    }
+    if (0U != baseline.skipped)
+    {
+        return Fail(codec, "frames skipped without silence detection");
+    }
+
+    bool ok = true;
+    for (int hangover : {2, 4})
+    {
+        for (SilenceMode mode : {SilenceMode::kCachedFrame, SilenceMode::kGap})
+        {
+            std::string  name = codec + (SilenceMode::kGap == mode ? " gap" : " cached") + " hangover "
+                             + std::to_string(hangover);
+            EncodeResult result;
+            if (!Encode<Encoder>(mode, hangover, result))
+            {
+                ok = Fail(name, "failed to encode");
+                continue;
+            }
+            ok = Check(name, mode, hangover, baseline, result, mp3) && ok;
+        }
+    }
+
+    return ok;
+}
+} // namespace
+
+int main()
+{
+    bool ok = Run<AudioEncoderAAC>("AAC", false);
+    ok      = Run<AudioEncoderMP3>("MP3", true) && ok;
+    if (!ok)
+    {
+        return 1;
+    }
+
+    std::cout << "silence_skip_test: ok" << std::endl;
+
+    return 0;
+}